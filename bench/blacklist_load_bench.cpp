@@ -0,0 +1,94 @@
+// Startup cost of an N-entry blacklist: reading it from a blacklist_file with 1..max threads and building the
+// lookup structure, against parsing the same list as the JSON "blacklist" array.
+// Usage: blacklist_load_bench [entries] [max_threads] [json]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <blacklist.hpp>
+#include <blacklist_file.hpp>
+#include <config.hpp>
+
+namespace {
+    double seconds_since(std::chrono::steady_clock::time_point started_at) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+    }
+
+    void write_lists(const std::filesystem::path &text_path, const std::filesystem::path &json_path, size_t entries,
+                     bool with_json) {
+        std::ofstream text(text_path);
+        std::ofstream json;
+        if (with_json) {
+            json.open(json_path);
+            json << R"({"blacklist": [)";
+        }
+
+        std::mt19937_64 rng(3);
+        for (size_t i = 0; i < entries; ++i) {
+            auto imsi = "00101" + std::to_string(1000000000 + rng() % 9000000000);
+            text << imsi << '\n';
+            if (with_json) {
+                json << (i == 0 ? "\"" : ",\"") << imsi << '"';
+            }
+        }
+
+        if (with_json) {
+            json << "]}";
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t entries = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10'000'000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    bool with_json = argc > 3 && std::strcmp(argv[3], "json") == 0;
+
+    auto dir = std::filesystem::temp_directory_path();
+    auto text_path = dir / "blacklist_load_bench.txt";
+    auto json_path = dir / "blacklist_load_bench.json";
+    write_lists(text_path, json_path, entries, with_json);
+
+    std::printf("entries %zu  file %.1f MiB  hardware threads %u\n", entries,
+                static_cast<double>(std::filesystem::file_size(text_path)) / (1024.0 * 1024.0),
+                std::thread::hardware_concurrency());
+
+    for (size_t threads = 1; threads <= std::max<size_t>(max_threads, 1); threads *= 2) {
+        auto started_at = std::chrono::steady_clock::now();
+        auto contents = read_blacklist_file(text_path, threads);
+        double read = seconds_since(started_at);
+
+        started_at = std::chrono::steady_clock::now();
+        blacklist list(std::move(contents.imsis));
+        double build = seconds_since(started_at);
+
+        std::printf("file  threads %3zu  read %7.1f ms  build %7.1f ms  total %7.1f ms  (%zu unique)\n", threads,
+                    read * 1e3, build * 1e3, (read + build) * 1e3, list.size());
+    }
+
+    if (with_json) {
+        auto started_at = std::chrono::steady_clock::now();
+        config cfg(json_path);
+        double parse = seconds_since(started_at);
+
+        started_at = std::chrono::steady_clock::now();
+        std::vector<packed_imsi> imsis;
+        for (const auto &entry: cfg.get_blacklist().value()) {
+            imsis.push_back(packed_imsi::from_string(entry).value());
+        }
+        blacklist list(std::move(imsis));
+        double build = seconds_since(started_at);
+
+        std::printf("json               parse %7.1f ms  build %7.1f ms  total %7.1f ms  (%zu unique)\n", parse * 1e3,
+                    build * 1e3, (parse + build) * 1e3, list.size());
+    }
+
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(json_path);
+}
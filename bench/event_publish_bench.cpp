@@ -0,0 +1,168 @@
+// Publisher-side cost of event_bus::publish against the type_index/std::any bus it replaced, kept below as
+// legacy_event_bus, with the subscribers taking batches instead, and under the inline and dedicated-thread delivery
+// policies. Handlers are no-ops; time is measured on the publishing thread only, then the deliveries drain.
+// Usage: event_publish_bench [events] [handlers]
+
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <packed_imsi.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    // The previous event_bus: handlers found by type_index and any_cast out, std::function and all, per delivery.
+    class legacy_event_bus {
+    public:
+        explicit legacy_event_bus(std::shared_ptr<thread_pool> thread_pool) : _thread_pool(std::move(thread_pool)) {}
+
+        template<typename EventType, typename F>
+        void subscribe(F &&func) {
+            using ParamTuple = typename EventType::param_type;
+            auto type_index = std::type_index(typeid(EventType));
+
+            auto wrapper = [f = std::forward<F>(func)](const ParamTuple &params) { std::apply(f, params); };
+
+            _handlers[type_index].emplace_back(std::function<void(const ParamTuple &)>(wrapper));
+        }
+
+        template<typename EventType, typename... Args>
+        void publish(Args &&...args) {
+            using ParamTuple = typename EventType::param_type;
+            auto type_index = std::type_index(typeid(EventType));
+
+            ParamTuple params = std::make_tuple(std::forward<Args>(args)...);
+
+            auto it = _handlers.find(type_index);
+            if (it == _handlers.end()) {
+                return;
+            }
+
+            for (const auto &handler_any: it->second) {
+                auto handler = std::any_cast<std::function<void(const ParamTuple &)>>(handler_any);
+
+                _thread_pool->enqueue([handler, params]() { handler(params); });
+            }
+        }
+
+    private:
+        std::shared_ptr<thread_pool> _thread_pool;
+        std::unordered_map<std::type_index, std::vector<std::any>> _handlers;
+    };
+
+    std::filesystem::path write_config() {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "event_publish_bench.json";
+
+        std::ofstream(path) << R"({
+            "log_file": ")" << (dir / "event_publish_bench.log").string()
+                            << R"(",
+            "log_level": "error"
+        })";
+
+        return path;
+    }
+
+    // State a real subscriber might capture: more than std::function stores inline.
+    struct subscriber_state {
+        std::shared_ptr<std::atomic<uint64_t>> delivered = std::make_shared<std::atomic<uint64_t>>(0);
+        std::string name = "cdr_writer";
+    };
+
+    void subscribe_all(legacy_event_bus &bus, size_t handlers_num, const subscriber_state &state) {
+        for (size_t h = 0; h < handlers_num; ++h) {
+            bus.subscribe<events::create_session_event>(
+                    [state](packed_imsi) { state.delivered->fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+
+    void subscribe_all(event_bus &bus, size_t handlers_num, const subscriber_state &state,
+                       delivery_policy delivery = delivery_policy::pool) {
+        for (size_t h = 0; h < handlers_num; ++h) {
+            bus.subscribe<events::create_session_event>(
+                    [state](packed_imsi) { state.delivered->fetch_add(1, std::memory_order_relaxed); },
+                    {.delivery = delivery, .name = state.name});
+        }
+    }
+
+    void subscribe_batches(event_bus &bus, size_t handlers_num, const subscriber_state &state) {
+        for (size_t h = 0; h < handlers_num; ++h) {
+            bus.subscribe_batch<events::create_session_event>([state](std::span<const packed_imsi> imsis) {
+                state.delivered->fetch_add(imsis.size(), std::memory_order_relaxed);
+            });
+        }
+    }
+
+    template<typename Bus>
+    double measure(Bus &bus, size_t events_num, size_t handlers_num, const subscriber_state &state) {
+        auto imsi = packed_imsi::from_string("001010123456789").value();
+        uint64_t expected = state.delivered->load() + events_num * handlers_num;
+
+        auto started_at = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < events_num; ++i) {
+            bus.template publish<events::create_session_event>(imsi);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+        while (state.delivered->load() < expected) {
+            std::this_thread::yield();
+        }
+        return elapsed * 1e9 / static_cast<double>(events_num);
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t events_num = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    size_t max_handlers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    auto cfg = std::make_shared<config>(write_config());
+    auto log = std::make_shared<logger>(cfg);
+
+    for (size_t handlers_num = 1; handlers_num <= max_handlers; handlers_num *= 2) {
+        subscriber_state state;
+
+        auto legacy_pool = std::make_shared<thread_pool>(1, log);
+        legacy_event_bus legacy(legacy_pool);
+        subscribe_all(legacy, handlers_num, state);
+        double before = measure(legacy, events_num, handlers_num, state);
+
+        auto pool = std::make_shared<thread_pool>(1, log);
+        event_bus bus(pool, log);
+        subscribe_all(bus, handlers_num, state);
+        double after = measure(bus, events_num, handlers_num, state);
+
+        auto batch_pool = std::make_shared<thread_pool>(1, log);
+        event_bus batch_bus(batch_pool, log);
+        subscribe_batches(batch_bus, handlers_num, state);
+        double batched = measure(batch_bus, events_num, handlers_num, state);
+
+        auto inline_pool = std::make_shared<thread_pool>(1, log);
+        event_bus inline_bus(inline_pool, log);
+        subscribe_all(inline_bus, handlers_num, state, delivery_policy::publisher_thread);
+        double inlined = measure(inline_bus, events_num, handlers_num, state);
+
+        auto dedicated_pool = std::make_shared<thread_pool>(1, log);
+        event_bus dedicated_bus(dedicated_pool, log);
+        subscribe_all(dedicated_bus, handlers_num, state, delivery_policy::dedicated_thread);
+        double dedicated = measure(dedicated_bus, events_num, handlers_num, state);
+
+        std::printf("handlers %zu  legacy %7.1f  typed %7.1f  batched %6.1f  inline %6.1f  dedicated %6.1f "
+                    "ns/publish\n",
+                    handlers_num, before, after, batched, inlined, dedicated);
+    }
+}
@@ -0,0 +1,121 @@
+// Attach cost with and without a preallocated session table: N creations into an empty session_manager, counting
+// heap allocations and page faults taken by them, plus the slowest creations.
+// Usage: session_capacity_bench [sessions] [huge_pages 0|1]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    std::atomic<size_t> allocations{0};
+
+    std::filesystem::path write_config(size_t max_sessions, bool huge_pages) {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "session_capacity_bench.json";
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": 0,
+            "session_timeout_sec": 3600,
+            "cdr_file": ")" << (dir / "session_capacity_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "session_capacity_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "max_sessions": )" << max_sessions
+                            << R"(,
+            "session_huge_pages": )" << (huge_pages ? "true" : "false")
+                            << R"(,
+            "blacklist": []
+        })";
+
+        return path;
+    }
+
+    long minor_faults() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt;
+    }
+
+    void run(const char *name, size_t sessions_num, size_t max_sessions, bool huge_pages) {
+        auto cfg = std::make_shared<config>(write_config(max_sessions, huge_pages));
+        auto log = std::make_shared<logger>(cfg);
+        auto pool = std::make_shared<thread_pool>(1, log);
+        auto bus = std::make_shared<event_bus>(pool, log);
+
+        auto setup_started_at = std::chrono::steady_clock::now();
+        auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+        auto setup = std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_started_at).count();
+
+        std::vector<packed_imsi> imsis;
+        imsis.reserve(sessions_num + 1);
+        for (size_t i = 0; i <= sessions_num; ++i) {
+            imsis.push_back(packed_imsi::from_string("00101" + std::to_string(1000000000 + i)).value());
+        }
+        std::vector<uint32_t> latencies(sessions_num);
+
+        size_t allocations_before = allocations.load(std::memory_order_relaxed);
+        long faults_before = minor_faults();
+        auto started_at = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < sessions_num; ++i) {
+            auto op_started_at = std::chrono::steady_clock::now();
+            (void) sessions->create_session(imsis[i]);
+            latencies[i] = static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                         op_started_at)
+                            .count());
+        }
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+        long faults = minor_faults() - faults_before;
+        size_t allocated = allocations.load(std::memory_order_relaxed) - allocations_before;
+
+        bool refused = sessions->create_session(imsis[sessions_num]) == create_session_result::capacity_exceeded;
+
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%-12s setup %7.1f ms  attach %6.1f ns/session  p99.9 %6u ns  max %8u ns  allocations %zu  "
+                    "page faults %ld  next refused: %s\n",
+                    name, setup * 1e3, elapsed * 1e9 / static_cast<double>(sessions_num),
+                    latencies[latencies.size() * 999 / 1000], latencies.back(), allocated, faults,
+                    refused ? "yes" : "no");
+    }
+} // namespace
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char **argv) {
+    size_t sessions_num = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    bool huge_pages = argc > 2 && std::strtoul(argv[2], nullptr, 10) != 0;
+
+    run("unbounded", sessions_num, 0, false);
+    run("preallocated", sessions_num, sessions_num, huge_pages);
+}
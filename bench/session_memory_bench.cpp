@@ -0,0 +1,67 @@
+// Resident memory per session once the session table holds N subscribers.
+// Usage: session_memory_bench [sessions]
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    std::filesystem::path write_config() {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "session_memory_bench.json";
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": 0,
+            "session_timeout_sec": 3600,
+            "cdr_file": ")" << (dir / "session_memory_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "session_memory_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "blacklist": []
+        })";
+
+        return path;
+    }
+
+    size_t resident_bytes() {
+        size_t pages = 0;
+        size_t resident = 0;
+        std::ifstream("/proc/self/statm") >> pages >> resident;
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t sessions_num = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10'000'000;
+
+    auto cfg = std::make_shared<config>(write_config());
+    auto log = std::make_shared<logger>(cfg);
+    auto pool = std::make_shared<thread_pool>(1, log);
+    auto bus = std::make_shared<event_bus>(pool, log);
+    auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+
+    size_t before = resident_bytes();
+    for (size_t i = 0; i < sessions_num; ++i) {
+        auto imsi = packed_imsi::from_string("00101" + std::to_string(1000000000 + i)).value();
+        (void) sessions->create_session(imsi);
+    }
+    size_t after = resident_bytes();
+
+    std::printf("sessions %zu  resident %.1f MiB  %.1f bytes/session\n", sessions_num,
+                static_cast<double>(after - before) / (1024.0 * 1024.0),
+                static_cast<double>(after - before) / static_cast<double>(sessions_num));
+}
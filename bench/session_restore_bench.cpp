@@ -0,0 +1,79 @@
+// Warm restart: persist N sessions to a session state file, then time a fresh session_manager taking them back.
+// Usage: session_restore_bench [sessions]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    std::filesystem::path write_config(const std::filesystem::path &state_file) {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "session_restore_bench.json";
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": 0,
+            "session_timeout_sec": 3600,
+            "cdr_file": ")" << (dir / "session_restore_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "session_restore_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "session_state_file": ")" << state_file.string()
+                            << R"(",
+            "blacklist": []
+        })";
+
+        return path;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t sessions_num = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5'000'000;
+
+    auto state_file = std::filesystem::temp_directory_path() / "session_restore_bench.bin";
+    std::filesystem::remove(state_file);
+
+    auto cfg = std::make_shared<config>(write_config(state_file));
+    auto log = std::make_shared<logger>(cfg);
+    auto pool = std::make_shared<thread_pool>(1, log);
+    auto bus = std::make_shared<event_bus>(pool, log);
+
+    {
+        auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+
+        auto started_at = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sessions_num; ++i) {
+            auto imsi = packed_imsi::from_string("00101" + std::to_string(1000000000 + i)).value();
+            (void) sessions->create_session(imsi);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+        std::printf("persisted %zu sessions in %.1f ms (%.0f ns/session), file %.1f MiB\n", sessions_num,
+                    elapsed * 1e3, elapsed * 1e9 / static_cast<double>(sessions_num),
+                    static_cast<double>(std::filesystem::file_size(state_file)) / (1024.0 * 1024.0));
+    }
+
+    auto started_at = std::chrono::steady_clock::now();
+    auto restored = std::make_shared<session_manager>(cfg, bus, log);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+    auto probe = packed_imsi::from_string("00101" + std::to_string(1000000000 + sessions_num / 2)).value();
+    std::printf("restart with %zu sessions took %.1f ms (probe session %s)\n", sessions_num, elapsed * 1e3,
+                restored->has_active_session(probe) ? "active" : "missing");
+
+    restored.reset();
+    std::filesystem::remove(state_file);
+}
@@ -0,0 +1,101 @@
+// Session table throughput under concurrent create/lookup/delete from 1 to 32 threads.
+// Usage: session_table_bench [operations_per_thread] [max_threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    constexpr size_t KEYS_PER_THREAD = 4096;
+
+    std::filesystem::path write_config() {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "session_table_bench.json";
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": 0,
+            "session_timeout_sec": 3600,
+            "cdr_file": ")" << (dir / "session_table_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "session_table_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "blacklist": []
+        })";
+
+        return path;
+    }
+
+    // Each thread cycles through its own subscribers the way the UDP path and HTTP checks would hit them:
+    // create, look up, check the blacklist, delete.
+    void run_worker(session_manager &sessions, const std::vector<packed_imsi> &imsis, size_t operations) {
+        for (size_t i = 0; i < operations; i += 4) {
+            packed_imsi imsi = imsis[(i / 4) % imsis.size()];
+
+            (void) sessions.create_session(imsi);
+            (void) sessions.has_active_session(imsi);
+            (void) sessions.has_blacklist_session(imsi);
+            sessions.delete_session(imsi);
+        }
+    }
+
+    double measure(session_manager &sessions, size_t threads_num, size_t operations) {
+        std::vector<std::vector<packed_imsi>> imsis(threads_num);
+        for (size_t t = 0; t < threads_num; ++t) {
+            for (size_t k = 0; k < KEYS_PER_THREAD; ++k) {
+                auto imsi = "00101" + std::to_string(1000000000 + t * KEYS_PER_THREAD + k);
+                imsis[t].push_back(packed_imsi::from_string(imsi).value());
+            }
+        }
+
+        auto started_at = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> workers;
+            for (size_t t = 0; t < threads_num; ++t) {
+                workers.emplace_back([&, t]() { run_worker(sessions, imsis[t], operations); });
+            }
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+        return static_cast<double>(threads_num * operations) / elapsed;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+
+    auto cfg = std::make_shared<config>(write_config());
+    auto log = std::make_shared<logger>(cfg);
+    auto pool = std::make_shared<thread_pool>(1, log);
+    auto bus = std::make_shared<event_bus>(pool, log);
+    auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+    double baseline = 0.0;
+    for (size_t threads_num = 1; threads_num <= max_threads; threads_num *= 2) {
+        double ops_per_sec = measure(*sessions, threads_num, operations);
+        if (threads_num == 1) {
+            baseline = ops_per_sec;
+        }
+
+        std::printf("threads %3zu  %8.2f Mops/s  speedup %5.2fx\n", threads_num, ops_per_sec / 1e6,
+                    ops_per_sec / baseline);
+    }
+}
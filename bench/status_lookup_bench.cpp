@@ -0,0 +1,119 @@
+// Attach throughput of the UDP path while monitoring readers hammer subscriber status lookups.
+// Usage: status_lookup_bench [seconds] [writers] [readers]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+    constexpr size_t KEYS_PER_WRITER = 65536;
+
+    std::filesystem::path write_config() {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / "status_lookup_bench.json";
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": 0,
+            "session_timeout_sec": 3600,
+            "cdr_file": ")" << (dir / "status_lookup_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "status_lookup_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "blacklist": []
+        })";
+
+        return path;
+    }
+
+    packed_imsi subscriber(size_t n) {
+        return packed_imsi::from_string("00101" + std::to_string(1000000000 + n)).value();
+    }
+
+    struct result {
+        double attaches_per_sec;
+        double lookups_per_sec;
+    };
+
+    // Writers attach and detach their own subscribers like the UDP path; readers poll every writer's subscribers
+    // like a monitoring system calling /check_subscriber.
+    result measure(session_manager &sessions, std::chrono::duration<double> duration, size_t writers_num,
+                   size_t readers_num) {
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> attaches{0};
+        std::atomic<uint64_t> lookups{0};
+
+        {
+            std::vector<std::jthread> threads;
+            for (size_t w = 0; w < writers_num; ++w) {
+                threads.emplace_back([&, w]() {
+                    uint64_t count = 0;
+                    for (size_t i = 0; not done.load(std::memory_order_relaxed); ++i) {
+                        packed_imsi imsi = subscriber(w * KEYS_PER_WRITER + i % KEYS_PER_WRITER);
+                        if (sessions.create_session(imsi) == create_session_result::created) {
+                            count++;
+                        } else {
+                            sessions.delete_session(imsi);
+                        }
+                    }
+                    attaches.fetch_add(count);
+                });
+            }
+
+            for (size_t r = 0; r < readers_num; ++r) {
+                threads.emplace_back([&, r]() {
+                    uint64_t count = 0;
+                    for (size_t i = r; not done.load(std::memory_order_relaxed); i += 7919) {
+                        (void) sessions.has_active_session(subscriber(i % (writers_num * KEYS_PER_WRITER)));
+                        count++;
+                    }
+                    lookups.fetch_add(count);
+                });
+            }
+
+            std::this_thread::sleep_for(duration);
+            done = true;
+        }
+
+        return {static_cast<double>(attaches.load()) / duration.count(),
+                static_cast<double>(lookups.load()) / duration.count()};
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 2.0;
+    size_t writers_num = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t readers_num = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+
+    auto cfg = std::make_shared<config>(write_config());
+    auto log = std::make_shared<logger>(cfg);
+    auto pool = std::make_shared<thread_pool>(1, log);
+    auto bus = std::make_shared<event_bus>(pool, log);
+    auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+    auto duration = std::chrono::duration<double>(seconds);
+    auto alone = measure(*sessions, duration, writers_num, 0);
+    auto polled = measure(*sessions, duration, writers_num, readers_num);
+
+    std::printf("writers %zu, no readers   attaches %8.2f M/s\n", writers_num, alone.attaches_per_sec / 1e6);
+    std::printf("writers %zu, readers %zu   attaches %8.2f M/s  lookups %8.2f M/s\n", writers_num, readers_num,
+                polled.attaches_per_sec / 1e6, polled.lookups_per_sec / 1e6);
+}
@@ -0,0 +1,126 @@
+// Loopback request/response latency of the UDP path with and without reactor busy polling.
+// Usage: udp_latency_bench [requests] [busy_poll_us]
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <packet_manager.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+#include <udp_server.hpp>
+#include <utility.hpp>
+
+namespace {
+    constexpr uint16_t BENCH_PORT = 19500;
+    constexpr size_t WARMUP_REQUESTS = 1000;
+
+    std::filesystem::path write_config(uint32_t busy_poll_us) {
+        auto dir = std::filesystem::temp_directory_path();
+        auto path = dir / ("udp_latency_bench_" + std::to_string(busy_poll_us) + ".json");
+
+        std::ofstream(path) << R"({
+            "server_ip": "127.0.0.1",
+            "server_port": )" << BENCH_PORT
+                            << R"(,
+            "session_timeout_sec": 0,
+            "cdr_file": ")" << (dir / "udp_latency_bench_cdr.log").string()
+                            << R"(",
+            "http_port": 0,
+            "graceful_shutdown_rate": 1000,
+            "log_file": ")" << (dir / "udp_latency_bench.log").string()
+                            << R"(",
+            "log_level": "error",
+            "blacklist": [],
+            "udp_reactors": 1,
+            "udp_batch_size": 32,
+            "udp_inline_responses": true,
+            "udp_retransmit_cache_size": 0,
+            "udp_busy_poll_us": )" << busy_poll_us
+                            << "}";
+
+        return path;
+    }
+
+    std::vector<double> measure(uint32_t busy_poll_us, size_t requests) {
+        auto cfg = std::make_shared<config>(write_config(busy_poll_us));
+        auto log = std::make_shared<logger>(cfg);
+        auto pool = std::make_shared<thread_pool>(2, log);
+        auto bus = std::make_shared<event_bus>(pool, log);
+        auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+        auto packets = std::make_shared<packet_manager>(cfg, bus, sessions, log);
+        auto server = std::make_shared<udp_server>(cfg, packets, log, bus);
+
+        std::jthread server_thread([server]() { server->run(); });
+
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        timeval timeout{1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(BENCH_PORT);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+        std::vector<double> latencies_us;
+        latencies_us.reserve(requests);
+
+        char reply[64];
+        for (size_t i = 0; i < WARMUP_REQUESTS + requests; ++i) {
+            auto packet = utility::encode_imsi_to_bcd("00101" + std::to_string(1000000000 + i)).value();
+
+            auto started_at = std::chrono::steady_clock::now();
+            send(fd, packet.data(), packet.size(), 0);
+            if (recv(fd, reply, sizeof(reply), 0) <= 0) {
+                std::fprintf(stderr, "request %zu timed out\n", i);
+                continue;
+            }
+            auto elapsed = std::chrono::steady_clock::now() - started_at;
+
+            if (i >= WARMUP_REQUESTS) {
+                latencies_us.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+            }
+        }
+
+        close(fd);
+        server->stop();
+        server_thread.join();
+
+        std::sort(latencies_us.begin(), latencies_us.end());
+        return latencies_us;
+    }
+
+    double percentile(const std::vector<double> &sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+    }
+
+    void report(const char *mode, const std::vector<double> &latencies_us) {
+        std::printf("%-22s samples %7zu  p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us\n", mode, latencies_us.size(),
+                    percentile(latencies_us, 0.50), percentile(latencies_us, 0.99), percentile(latencies_us, 0.999));
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    uint32_t busy_poll_us = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+
+    report("epoll_wait", measure(0, requests));
+    report(("busy poll " + std::to_string(busy_poll_us) + "us").c_str(), measure(busy_poll_us, requests));
+}
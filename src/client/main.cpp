@@ -54,6 +54,9 @@ int main(int argc, char *argv[]) {
             } else if (response == "rejected") {
                 logger_->info("Session was rejected");
                 return 3;
+            } else if (response == "Error: capacity_exceeded") {
+                logger_->warning("Server has no capacity for new sessions");
+                return 6;
             } else {
                 logger_->warning("Unexpected server response: " + response);
                 return 4;
@@ -24,6 +24,25 @@ config::config(const std::filesystem::path &path) {
         _log_file = extract_value<std::filesystem::path>(json_data, "log_file");
         _log_level = extract_value<std::string>(json_data, "log_level");
         _blacklist = extract_value<std::unordered_set<std::string>>(json_data, "blacklist");
+        _blacklist_file = extract_value<std::filesystem::path>(json_data, "blacklist_file");
+        _session_state_file = extract_value<std::filesystem::path>(json_data, "session_state_file");
+        _cdr_batch_size = extract_value<uint32_t>(json_data, "cdr_batch_size");
+        _cdr_flush_interval_ms = extract_value<uint32_t>(json_data, "cdr_flush_interval_ms");
+        _max_sessions = extract_value<uint32_t>(json_data, "max_sessions");
+        _session_huge_pages = extract_value<bool>(json_data, "session_huge_pages");
+        _session_prefault = extract_value<bool>(json_data, "session_prefault");
+        _udp_batch_size = extract_value<uint32_t>(json_data, "udp_batch_size");
+        _udp_buffer_pool_size = extract_value<uint32_t>(json_data, "udp_buffer_pool_size");
+        _udp_reactors = extract_value<uint32_t>(json_data, "udp_reactors");
+        _udp_io_engine = extract_value<std::string>(json_data, "udp_io_engine");
+        _udp_inline_responses = extract_value<bool>(json_data, "udp_inline_responses");
+        _udp_batch_budget_us = extract_value<uint32_t>(json_data, "udp_batch_budget_us");
+        _udp_kernel_filter = extract_value<bool>(json_data, "udp_kernel_filter");
+        _udp_imsi_steering = extract_value<bool>(json_data, "udp_imsi_steering");
+        _udp_retransmit_cache_size = extract_value<uint32_t>(json_data, "udp_retransmit_cache_size");
+        _udp_retransmit_ttl_ms = extract_value<uint32_t>(json_data, "udp_retransmit_ttl_ms");
+        _udp_busy_poll_us = extract_value<uint32_t>(json_data, "udp_busy_poll_us");
+        _udp_socket_busy_poll = extract_value<bool>(json_data, "udp_socket_busy_poll");
     } catch (const nlohmann::json_abi_v3_12_0::detail::type_error &e) {
         throw config_exception("Invalid JSON: " + std::string(e.what()));
     }
@@ -53,4 +72,42 @@ std::optional<std::filesystem::path> config::get_log_file() const { return _log_
 
 std::optional<std::string> config::get_log_level() const { return _log_level; }
 
-std::optional<std::unordered_set<std::string>> config::get_blacklist() const { return _blacklist; }
+const std::optional<std::unordered_set<std::string>> &config::get_blacklist() const { return _blacklist; }
+
+std::optional<std::filesystem::path> config::get_blacklist_file() const { return _blacklist_file; }
+
+std::optional<std::filesystem::path> config::get_session_state_file() const { return _session_state_file; }
+
+std::optional<uint32_t> config::get_cdr_batch_size() const { return _cdr_batch_size; }
+
+std::optional<uint32_t> config::get_cdr_flush_interval_ms() const { return _cdr_flush_interval_ms; }
+
+std::optional<uint32_t> config::get_max_sessions() const { return _max_sessions; }
+
+std::optional<bool> config::get_session_huge_pages() const { return _session_huge_pages; }
+
+std::optional<bool> config::get_session_prefault() const { return _session_prefault; }
+
+std::optional<uint32_t> config::get_udp_batch_size() const { return _udp_batch_size; }
+
+std::optional<uint32_t> config::get_udp_buffer_pool_size() const { return _udp_buffer_pool_size; }
+
+std::optional<uint32_t> config::get_udp_reactors() const { return _udp_reactors; }
+
+std::optional<std::string> config::get_udp_io_engine() const { return _udp_io_engine; }
+
+std::optional<bool> config::get_udp_inline_responses() const { return _udp_inline_responses; }
+
+std::optional<uint32_t> config::get_udp_batch_budget_us() const { return _udp_batch_budget_us; }
+
+std::optional<bool> config::get_udp_kernel_filter() const { return _udp_kernel_filter; }
+
+std::optional<bool> config::get_udp_imsi_steering() const { return _udp_imsi_steering; }
+
+std::optional<uint32_t> config::get_udp_retransmit_cache_size() const { return _udp_retransmit_cache_size; }
+
+std::optional<uint32_t> config::get_udp_retransmit_ttl_ms() const { return _udp_retransmit_ttl_ms; }
+
+std::optional<uint32_t> config::get_udp_busy_poll_us() const { return _udp_busy_poll_us; }
+
+std::optional<bool> config::get_udp_socket_busy_poll() const { return _udp_socket_busy_poll; }
@@ -27,7 +27,27 @@ public:
     [[nodiscard]] std::optional<uint32_t> get_graceful_shutdown_rate() const;
     [[nodiscard]] std::optional<std::filesystem::path> get_log_file() const;
     [[nodiscard]] std::optional<std::string> get_log_level() const;
-    [[nodiscard]] std::optional<std::unordered_set<std::string>> get_blacklist() const;
+    // By reference: the list may hold many entries.
+    [[nodiscard]] const std::optional<std::unordered_set<std::string>> &get_blacklist() const;
+    [[nodiscard]] std::optional<std::filesystem::path> get_blacklist_file() const;
+    [[nodiscard]] std::optional<std::filesystem::path> get_session_state_file() const;
+    [[nodiscard]] std::optional<uint32_t> get_cdr_batch_size() const;
+    [[nodiscard]] std::optional<uint32_t> get_cdr_flush_interval_ms() const;
+    [[nodiscard]] std::optional<uint32_t> get_max_sessions() const;
+    [[nodiscard]] std::optional<bool> get_session_huge_pages() const;
+    [[nodiscard]] std::optional<bool> get_session_prefault() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_batch_size() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_buffer_pool_size() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_reactors() const;
+    [[nodiscard]] std::optional<std::string> get_udp_io_engine() const;
+    [[nodiscard]] std::optional<bool> get_udp_inline_responses() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_batch_budget_us() const;
+    [[nodiscard]] std::optional<bool> get_udp_kernel_filter() const;
+    [[nodiscard]] std::optional<bool> get_udp_imsi_steering() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_retransmit_cache_size() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_retransmit_ttl_ms() const;
+    [[nodiscard]] std::optional<uint32_t> get_udp_busy_poll_us() const;
+    [[nodiscard]] std::optional<bool> get_udp_socket_busy_poll() const;
 
 private:
     template<typename T>
@@ -43,4 +63,23 @@ private:
     std::optional<std::filesystem::path> _log_file;
     std::optional<std::string> _log_level;
     std::optional<std::unordered_set<std::string>> _blacklist;
+    std::optional<std::filesystem::path> _blacklist_file;
+    std::optional<std::filesystem::path> _session_state_file;
+    std::optional<uint32_t> _cdr_batch_size;
+    std::optional<uint32_t> _cdr_flush_interval_ms;
+    std::optional<uint32_t> _max_sessions;
+    std::optional<bool> _session_huge_pages;
+    std::optional<bool> _session_prefault;
+    std::optional<uint32_t> _udp_batch_size;
+    std::optional<uint32_t> _udp_buffer_pool_size;
+    std::optional<uint32_t> _udp_reactors;
+    std::optional<std::string> _udp_io_engine;
+    std::optional<bool> _udp_inline_responses;
+    std::optional<uint32_t> _udp_batch_budget_us;
+    std::optional<bool> _udp_kernel_filter;
+    std::optional<bool> _udp_imsi_steering;
+    std::optional<uint32_t> _udp_retransmit_cache_size;
+    std::optional<uint32_t> _udp_retransmit_ttl_ms;
+    std::optional<uint32_t> _udp_busy_poll_us;
+    std::optional<bool> _udp_socket_busy_poll;
 };
\ No newline at end of file
@@ -35,12 +35,14 @@ public:
 
     void log(log_level level, std::string_view message);
 
+    [[nodiscard]] bool is_enabled(log_level level) const { return level >= _min_level; }
+
 private:
     void setup(const std::filesystem::path &log_file, const std::string &log_level_str);
     log_level parse_log_level(const std::string &level_str);
 
 private:
     std::shared_ptr<config> _config;
-    boost::log::sources::severity_logger<log_level> _logger;
+    boost::log::sources::severity_logger_mt<log_level> _logger;
     log_level _min_level;
 };
@@ -0,0 +1,30 @@
+#include <packed_imsi.hpp>
+
+std::optional<packed_imsi> packed_imsi::from_string(std::string_view imsi) {
+    if (imsi.empty() || imsi.size() > MAX_DIGITS) {
+        return std::nullopt;
+    }
+
+    uint64_t digits = 0;
+    for (char c: imsi) {
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        digits = (digits << 4) | static_cast<uint64_t>(c - '0');
+    }
+
+    return from_digits(digits, imsi.size());
+}
+
+std::string packed_imsi::to_string() const {
+    // At most 15 characters, which stays within the small-string buffer.
+    std::string imsi(size(), '0');
+
+    uint64_t digits = _packed;
+    for (size_t i = imsi.size(); i > 0; --i) {
+        imsi[i - 1] = static_cast<char>('0' + (digits & 0x0F));
+        digits >>= 4;
+    }
+
+    return imsi;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// An IMSI of up to 15 digits packed into one word: the digit count in the top nibble, then one decimal digit per
+// nibble, most significant first (001010123456789 is 0xF001010123456789). Leading zeros survive the round trip, and
+// the value is trivially copyable, so it can key tables and travel through events without allocating.
+class packed_imsi {
+public:
+    static constexpr size_t MAX_DIGITS = 15;
+
+    constexpr packed_imsi() = default;
+
+    // `digits` holds `count` decimal digits, one per nibble, the last digit in the lowest nibble.
+    [[nodiscard]] static constexpr packed_imsi from_digits(uint64_t digits, size_t count) {
+        return packed_imsi((static_cast<uint64_t>(count) << COUNT_SHIFT) | digits);
+    }
+    [[nodiscard]] static constexpr packed_imsi from_packed(uint64_t packed) { return packed_imsi(packed); }
+    [[nodiscard]] static std::optional<packed_imsi> from_string(std::string_view imsi);
+
+    [[nodiscard]] std::string to_string() const;
+
+    [[nodiscard]] constexpr uint64_t packed() const { return _packed; }
+    [[nodiscard]] constexpr size_t size() const { return static_cast<size_t>(_packed >> COUNT_SHIFT); }
+    [[nodiscard]] constexpr bool empty() const { return size() == 0; }
+
+    friend constexpr auto operator<=>(const packed_imsi &, const packed_imsi &) = default;
+
+private:
+    static constexpr uint32_t COUNT_SHIFT = 60;
+
+    explicit constexpr packed_imsi(uint64_t packed) : _packed(packed) {}
+
+    uint64_t _packed = 0;
+};
+
+template<>
+struct std::hash<packed_imsi> {
+    size_t operator()(const packed_imsi &imsi) const noexcept {
+        // splitmix64 finalizer: consecutive IMSIs differ only in low nibbles, so spread them over every bit.
+        uint64_t x = imsi.packed();
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<size_t>(x ^ (x >> 31));
+    }
+};
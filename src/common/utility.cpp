@@ -8,12 +8,12 @@
 
 namespace utility {
 
-    std::expected<std::string, decode_error> decode_imsi_from_bcd(std::span<const uint8_t> packet) {
-        if (packet.size() < 4) {
+    std::expected<packed_imsi, decode_error> decode_imsi_from_bcd(std::span<const uint8_t> packet) {
+        if (packet.size() < IMSI_HEADER_SIZE) {
             return std::unexpected(decode_error::packet_too_short);
         }
 
-        if (packet[0] != 1) {
+        if (packet[0] != IMSI_TYPE) {
             return std::unexpected(decode_error::invalid_imsi_type);
         }
 
@@ -24,23 +24,30 @@ namespace utility {
             return std::unexpected(decode_error::packet_size_mismatch);
         }
 
-        std::string imsi{};
-        imsi.reserve(declared_length * 2);
+        // BCD already stores one digit per nibble; only the nibble order within a byte is swapped.
+        uint64_t digits = 0;
+        size_t count = 0;
 
-        for (size_t i = 4; i < packet.size(); ++i) {
+        for (size_t i = IMSI_HEADER_SIZE; i < packet.size(); ++i) {
             uint8_t byte = packet[i];
 
             uint8_t digit1 = byte & 0x0F;
             uint8_t digit2 = (byte >> 4) & 0x0F;
 
+            if (count >= MAX_IMSI_DIGITS) {
+                return std::unexpected(decode_error::invalid_imsi_length);
+            }
+
             if (digit1 <= 9) {
-                imsi.push_back('0' + digit1);
+                digits = (digits << 4) | digit1;
+                count++;
             } else {
                 return std::unexpected(decode_error::invalid_bcd_digit);
             }
 
             if (digit2 <= 9) {
-                imsi.push_back('0' + digit2);
+                digits = (digits << 4) | digit2;
+                count++;
             } else if (digit2 == 0x0F) {
                 break;
             } else {
@@ -48,11 +55,11 @@ namespace utility {
             }
         }
 
-        if (imsi.length() > 15 or imsi.length() < 6) {
+        if (count > MAX_IMSI_DIGITS or count < MIN_IMSI_DIGITS) {
             return std::unexpected(decode_error::invalid_imsi_length);
         }
 
-        return imsi;
+        return packed_imsi::from_digits(digits, count);
     }
 
     std::expected<std::vector<uint8_t>, encode_error> encode_imsi_to_bcd(const std::string &imsi) {
@@ -62,7 +69,7 @@ namespace utility {
 
         std::vector<uint8_t> bcd_data;
 
-        bcd_data.push_back(0x01);
+        bcd_data.push_back(IMSI_TYPE);
 
         size_t bcd_bytes_needed = (imsi.length() + 1) / 2;
 
@@ -95,7 +102,7 @@ namespace utility {
     }
 
     bool is_valid_imsi(const std::string &imsi) {
-        if (imsi.empty() || imsi.length() < 6 || imsi.length() > 15) {
+        if (imsi.empty() || imsi.length() < MIN_IMSI_DIGITS || imsi.length() > MAX_IMSI_DIGITS) {
             return false;
         }
 
@@ -6,7 +6,16 @@
 #include <string>
 #include <vector>
 
+#include <packed_imsi.hpp>
+
 namespace utility {
+    constexpr uint8_t IMSI_TYPE = 1;
+    constexpr size_t IMSI_HEADER_SIZE = 4;
+    constexpr size_t MIN_IMSI_DIGITS = 6;
+    constexpr size_t MAX_IMSI_DIGITS = packed_imsi::MAX_DIGITS;
+    constexpr size_t MIN_IMSI_PACKET_SIZE = IMSI_HEADER_SIZE + (MIN_IMSI_DIGITS + 1) / 2;
+    constexpr size_t MAX_IMSI_PACKET_SIZE = IMSI_HEADER_SIZE + (MAX_IMSI_DIGITS + 1) / 2;
+
     enum class decode_error {
         packet_too_short,
         invalid_imsi_type,
@@ -17,7 +26,7 @@ namespace utility {
 
     enum class encode_error { invalid_imsi_format };
 
-    [[nodiscard]] std::expected<std::string, decode_error> decode_imsi_from_bcd(std::span<const uint8_t> packet);
+    [[nodiscard]] std::expected<packed_imsi, decode_error> decode_imsi_from_bcd(std::span<const uint8_t> packet);
     [[nodiscard]] std::expected<std::vector<uint8_t>, encode_error> encode_imsi_to_bcd(const std::string &imsi);
     [[nodiscard]] bool is_valid_imsi(const std::string &imsi);
     [[nodiscard]] std::string get_current_timestamp();
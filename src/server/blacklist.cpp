@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+#include <blacklist.hpp>
+
+blacklist::blacklist(std::vector<packed_imsi> imsis) {
+    // The file loader hands over sorted, unique IMSIs; checking that is a linear pass, sorting them again is not.
+    if (std::adjacent_find(imsis.begin(), imsis.end(), std::greater_equal<>{}) != imsis.end()) {
+        std::sort(imsis.begin(), imsis.end());
+        imsis.erase(std::unique(imsis.begin(), imsis.end()), imsis.end());
+    }
+
+    if (imsis.empty()) {
+        return;
+    }
+
+    _size = imsis.size();
+    _keys.reset(static_cast<uint64_t *>(::operator new[](keys_bytes(), std::align_val_t{CACHE_LINE_SIZE})));
+    _keys[0] = 0;
+
+    size_t next = 0;
+    build_tree(imsis, next, 1);
+
+    build_filter();
+}
+
+bool blacklist::contains(packed_imsi imsi) const {
+    if (_size == 0) {
+        return false;
+    }
+
+    uint64_t key = imsi.packed();
+    if (not filter_may_contain(std::hash<packed_imsi>{}(imsi))) {
+        return false;
+    }
+
+    // Branch-free descent: each step goes left (2k) or right (2k + 1). Running off the bottom leaves the path in k;
+    // stripping the trailing right turns plus one leads back to the last node where the search went left, which
+    // holds the lower bound.
+    const uint64_t *keys = _keys.get();
+    size_t n = _size;
+    size_t k = 1;
+    while (k <= n) {
+        __builtin_prefetch(keys + std::min(k * 8, n));
+        k = 2 * k + (keys[k] < key);
+    }
+    k >>= std::countr_one(k) + 1;
+
+    return k != 0 && keys[k] == key;
+}
+
+std::vector<packed_imsi> blacklist::entries() const {
+    std::vector<packed_imsi> sorted;
+    sorted.reserve(_size);
+    collect_tree(sorted, 1);
+    return sorted;
+}
+
+size_t blacklist::memory_usage() const { return filter_memory_usage() + (_size == 0 ? 0 : keys_bytes()); }
+
+uint64_t blacklist::probe_hash(uint64_t hash) {
+    // A second, independent mix for the in-block bit positions; the block itself comes from the first hash.
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void blacklist::build_filter() {
+    size_t bits = std::max<size_t>(size() * FILTER_BITS_PER_KEY, BLOCK_BITS);
+    _blocks.resize(std::bit_ceil(bits / BLOCK_BITS));
+    _block_mask = _blocks.size() - 1;
+
+    for (size_t i = 1; i <= _size; ++i) {
+        uint64_t hash = std::hash<packed_imsi>{}(packed_imsi::from_packed(_keys[i]));
+        block &target = _blocks[hash & _block_mask];
+
+        uint64_t bits_hash = probe_hash(hash);
+        for (uint32_t probe = 0; probe < FILTER_PROBES; ++probe) {
+            uint64_t bit = (bits_hash >> (probe * 9)) & (BLOCK_BITS - 1);
+            target.words[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+    }
+}
+
+void blacklist::build_tree(const std::vector<packed_imsi> &sorted, size_t &next, size_t node) {
+    // In-order walk of the implicit tree hands out the sorted keys, which yields the Eytzinger layout. Recursion
+    // depth is log2(n).
+    if (node > _size) {
+        return;
+    }
+
+    build_tree(sorted, next, 2 * node);
+    _keys[node] = sorted[next++].packed();
+    build_tree(sorted, next, 2 * node + 1);
+}
+
+void blacklist::collect_tree(std::vector<packed_imsi> &sorted, size_t node) const {
+    if (node > _size) {
+        return;
+    }
+
+    collect_tree(sorted, 2 * node);
+    sorted.push_back(packed_imsi::from_packed(_keys[node]));
+    collect_tree(sorted, 2 * node + 1);
+}
+
+size_t blacklist::keys_bytes() const {
+    size_t bytes = (_size + 1) * sizeof(uint64_t);
+    return (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+bool blacklist::filter_may_contain(uint64_t hash) const {
+    const block &target = _blocks[hash & _block_mask];
+
+    uint64_t bits_hash = probe_hash(hash);
+    for (uint32_t probe = 0; probe < FILTER_PROBES; ++probe) {
+        uint64_t bit = (bits_hash >> (probe * 9)) & (BLOCK_BITS - 1);
+        if ((target.words[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <packed_imsi.hpp>
+
+// Immutable set of blacklisted IMSIs sized for millions of entries. A blocked Bloom filter answers most negatives
+// from one cache line; the rest search the packed IMSIs laid out in Eytzinger (BFS) order, where the top of the
+// implicit tree shares a few cache lines and each further level is a predictable prefetch. Lookups only read, so
+// any number of threads may call contains() without locking.
+class blacklist {
+public:
+    blacklist() = default;
+    explicit blacklist(std::vector<packed_imsi> imsis);
+
+    [[nodiscard]] bool contains(packed_imsi imsi) const;
+    // All entries in ascending order, ready to build a changed copy from.
+    [[nodiscard]] std::vector<packed_imsi> entries() const;
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] size_t memory_usage() const;
+    [[nodiscard]] size_t filter_memory_usage() const { return _blocks.size() * sizeof(block); }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t BLOCK_BITS = CACHE_LINE_SIZE * 8;
+    static constexpr size_t FILTER_BITS_PER_KEY = 12;
+    static constexpr uint32_t FILTER_PROBES = 6;
+
+    struct alignas(CACHE_LINE_SIZE) block {
+        uint64_t words[BLOCK_BITS / 64] = {};
+    };
+
+    struct aligned_delete {
+        void operator()(uint64_t *keys) const { ::operator delete[](keys, std::align_val_t{CACHE_LINE_SIZE}); }
+    };
+
+    [[nodiscard]] static uint64_t probe_hash(uint64_t hash);
+
+    void build_filter();
+    void build_tree(const std::vector<packed_imsi> &sorted, size_t &next, size_t node);
+    void collect_tree(std::vector<packed_imsi> &sorted, size_t node) const;
+    [[nodiscard]] size_t keys_bytes() const;
+    [[nodiscard]] bool filter_may_contain(uint64_t hash) const;
+
+private:
+    std::vector<block> _blocks;
+    uint64_t _block_mask = 0;
+
+    // 1-based Eytzinger order with _keys[0] unused, so the eight nodes three levels below node k (8k..8k+7) share
+    // one cache line, which is what the search prefetches.
+    std::unique_ptr<uint64_t[], aligned_delete> _keys;
+    size_t _size = 0;
+};
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include <blacklist_file.hpp>
+
+namespace {
+    // Below this a chunk costs more to hand to a thread than to parse.
+    constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    struct mapping_delete {
+        size_t size;
+        void operator()(const char *data) const { munmap(const_cast<char *>(data), size); }
+    };
+
+    struct chunk {
+        std::vector<packed_imsi> imsis;
+        size_t invalid_lines = 0;
+    };
+
+    std::string_view trim(std::string_view line) {
+        constexpr std::string_view blanks = " \t\r";
+
+        size_t first = line.find_first_not_of(blanks);
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        return line.substr(first, line.find_last_not_of(blanks) - first + 1);
+    }
+
+    void parse_chunk(std::string_view text, chunk &out) {
+        // About 16 bytes per line, so this is close to one allocation for the whole chunk.
+        out.imsis.reserve(text.size() / 16 + 1);
+
+        while (not text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = trim(text.substr(0, end));
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            auto imsi = packed_imsi::from_string(line);
+            if (not imsi.has_value()) {
+                ++out.invalid_lines;
+                continue;
+            }
+            out.imsis.push_back(imsi.value());
+        }
+
+        std::sort(out.imsis.begin(), out.imsis.end());
+        out.imsis.erase(std::unique(out.imsis.begin(), out.imsis.end()), out.imsis.end());
+    }
+
+    // Start of each chunk, moved forward to the beginning of a line; the last entry is the end of the text.
+    std::vector<size_t> split_at_lines(std::string_view text, size_t chunks_num) {
+        std::vector<size_t> bounds{0};
+        for (size_t i = 1; i < chunks_num; ++i) {
+            size_t position = std::max(bounds.back(), text.size() / chunks_num * i);
+            size_t newline = text.find('\n', position);
+            bounds.push_back(newline == std::string_view::npos ? text.size() : newline + 1);
+        }
+        bounds.push_back(text.size());
+        return bounds;
+    }
+} // namespace
+
+blacklist_file_contents read_blacklist_file(const std::filesystem::path &path, size_t threads) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw blacklist_file_exception("Cannot open blacklist file " + path.string() + ": " + strerror(errno));
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        close(fd);
+        throw blacklist_file_exception("Cannot stat blacklist file " + path.string() + ": " + strerror(error));
+    }
+
+    auto size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        close(fd);
+        return {};
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    int error = errno;
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw blacklist_file_exception("Cannot map blacklist file " + path.string() + ": " + strerror(error));
+    }
+
+    std::unique_ptr<const char, mapping_delete> mapping(static_cast<const char *>(data), mapping_delete{size});
+    return parse_blacklist(std::string_view(mapping.get(), size), threads);
+}
+
+blacklist_file_contents parse_blacklist(std::string_view text, size_t threads) {
+    blacklist_file_contents contents;
+
+    size_t chunks_num = std::clamp<size_t>(text.size() / MIN_CHUNK_BYTES, 1, std::max<size_t>(threads, 1));
+    std::vector<size_t> bounds = split_at_lines(text, chunks_num);
+
+    std::vector<chunk> chunks(chunks_num);
+    {
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i < chunks_num; ++i) {
+            workers.emplace_back(
+                    [&, i]() { parse_chunk(text.substr(bounds[i], bounds[i + 1] - bounds[i]), chunks[i]); });
+        }
+    }
+
+    // Lay the sorted runs out back to back, then merge neighbours pairwise, halving the run count each round.
+    std::vector<size_t> runs{0};
+    for (const auto &parsed: chunks) {
+        runs.push_back(runs.back() + parsed.imsis.size());
+    }
+
+    contents.imsis.reserve(runs.back());
+    for (auto &parsed: chunks) {
+        contents.imsis.insert(contents.imsis.end(), parsed.imsis.begin(), parsed.imsis.end());
+        contents.invalid_lines += parsed.invalid_lines;
+        parsed.imsis = {};
+    }
+
+    auto &imsis = contents.imsis;
+    while (runs.size() > 2) {
+        std::vector<size_t> merged{0};
+        {
+            std::vector<std::jthread> workers;
+            for (size_t i = 0; i + 2 < runs.size(); i += 2) {
+                workers.emplace_back([&imsis, first = runs[i], middle = runs[i + 1], last = runs[i + 2]]() {
+                    std::inplace_merge(imsis.begin() + static_cast<ptrdiff_t>(first),
+                                       imsis.begin() + static_cast<ptrdiff_t>(middle),
+                                       imsis.begin() + static_cast<ptrdiff_t>(last));
+                });
+                merged.push_back(runs[i + 2]);
+            }
+        }
+        if (runs.size() % 2 == 0) {
+            merged.push_back(runs.back());
+        }
+        runs = std::move(merged);
+    }
+
+    // Chunks deduplicate on their own, but the same IMSI may appear in two of them.
+    imsis.erase(std::unique(imsis.begin(), imsis.end()), imsis.end());
+
+    return contents;
+}
+
+void merge_blacklists(std::vector<packed_imsi> &imsis, std::vector<packed_imsi> sorted) {
+    std::sort(imsis.begin(), imsis.end());
+    auto middle = static_cast<std::ptrdiff_t>(imsis.size());
+    imsis.insert(imsis.end(), sorted.begin(), sorted.end());
+    sorted = {};
+    std::inplace_merge(imsis.begin(), imsis.begin() + middle, imsis.end());
+    imsis.erase(std::unique(imsis.begin(), imsis.end()), imsis.end());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <packed_imsi.hpp>
+
+class blacklist_file_exception : public std::runtime_error {
+public:
+    explicit blacklist_file_exception(const std::string &message) :
+        std::runtime_error("blacklist_file_exception: " + message) {}
+};
+
+struct blacklist_file_contents {
+    std::vector<packed_imsi> imsis; // sorted, without duplicates
+    size_t invalid_lines = 0;
+};
+
+// Reads a blacklist kept apart from the JSON config: one IMSI per line, with blank lines and lines starting with '#'
+// skipped. The file is mapped rather than streamed and split at line boundaries into one chunk per thread; each
+// thread parses and sorts its chunk, and the sorted runs are merged pairwise, so the result can be handed to
+// blacklist without another sort.
+[[nodiscard]] blacklist_file_contents read_blacklist_file(const std::filesystem::path &path, size_t threads);
+// The same for text already in memory, such as a request body.
+[[nodiscard]] blacklist_file_contents parse_blacklist(std::string_view text, size_t threads);
+// Sorts imsis, merges the already sorted file list into it and drops duplicates, so listing the same IMSI in the
+// config and in the file is harmless.
+void merge_blacklists(std::vector<packed_imsi> &imsis, std::vector<packed_imsi> sorted);
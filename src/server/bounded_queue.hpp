@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+template<typename T>
+class bounded_queue {
+public:
+    explicit bounded_queue(size_t capacity = 0) : _items(capacity) {}
+
+    void reset(size_t capacity) {
+        _items.assign(capacity, T{});
+        _head = 0;
+        _size = 0;
+    }
+
+    [[nodiscard]] bool push(T item) {
+        if (_size == _items.size()) {
+            return false;
+        }
+
+        _items[(_head + _size) % _items.size()] = std::move(item);
+        _size++;
+        return true;
+    }
+
+    T &front() { return _items[_head]; }
+    T &operator[](size_t index) { return _items[(_head + index) % _items.size()]; }
+
+    void pop() {
+        _head = (_head + 1) % _items.size();
+        _size--;
+    }
+
+    [[nodiscard]] bool empty() const { return _size == 0; }
+    [[nodiscard]] bool full() const { return _size == _items.size(); }
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] size_t capacity() const { return _items.size(); }
+
+private:
+    std::vector<T> _items;
+    size_t _head = 0;
+    size_t _size = 0;
+};
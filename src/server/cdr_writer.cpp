@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include <cdr_writer.hpp>
 
 #include <config.hpp>
@@ -32,31 +34,42 @@ void cdr_writer::setup() {
         throw cdr_writer_exception("Unable to get CDR file path in config.json");
     }
 
-    _event_bus->subscribe<events::create_session_event>([this](std::string imsi) {
-        _logger->debug("Received create_session_event for IMSI: " + imsi);
-        cdr_record record{
-                .timestamp = utility::get_current_timestamp(), .imsi = std::move(imsi), .action = cdr_action::created};
-        write_record(std::move(record));
-    });
-
-    _event_bus->subscribe<events::delete_session_event>([this](std::string imsi) {
-        _logger->debug("Received delete_session_event for IMSI: " + imsi);
-        cdr_record record{
-                .timestamp = utility::get_current_timestamp(), .imsi = std::move(imsi), .action = cdr_action::deleted};
-        write_record(std::move(record));
-    });
-
-    _event_bus->subscribe<events::reject_session_event>([this](std::string imsi) {
-        _logger->debug("Received reject_session_event for IMSI: " + imsi);
-        cdr_record record{
-                .timestamp = utility::get_current_timestamp(), .imsi = std::move(imsi), .action = cdr_action::rejected};
-        write_record(std::move(record));
-    });
+    // Single-session events arrive in batches: one pool task, one lock and one flush per batch rather than per
+    // session. A record is stamped when its batch is written, at most max_delay after the event.
+    batch_options batching{.max_events = _config->get_cdr_batch_size().value_or(256),
+                           .max_delay = std::chrono::milliseconds(_config->get_cdr_flush_interval_ms().value_or(10))};
+    _logger->info("CDR records are written in batches of up to " + std::to_string(batching.max_events) +
+                  " or every " + std::to_string(batching.max_delay.count()) + " ms");
+    subscription_options delivery{.name = "cdr_writer"};
+
+    _created = _event_bus->subscribe_batch<events::create_session_event>(
+            [this](std::span<const packed_imsi> imsis) { write_records(imsis, cdr_action::created); }, batching,
+            delivery);
+
+    _deleted = _event_bus->subscribe<events::delete_sessions_event>(
+            [this](const std::vector<packed_imsi> &imsis) {
+                _logger->debug("Received delete_sessions_event for " + std::to_string(imsis.size()) + " IMSIs");
+                write_records(imsis, cdr_action::deleted);
+            },
+            delivery);
+
+    _rejected = _event_bus->subscribe_batch<events::reject_session_event>(
+            [this](std::span<const packed_imsi> imsis) { write_records(imsis, cdr_action::rejected); }, batching,
+            delivery);
+
+    _shed = _event_bus->subscribe_batch<events::shed_session_event>(
+            [this](std::span<const packed_imsi> imsis) { write_records(imsis, cdr_action::shed); }, batching, delivery);
 
     _logger->debug("CDR writer setup completed");
 }
 
 cdr_writer::~cdr_writer() {
+    // Records still buffered in the bus are written before the file closes, and nothing reaches the handlers after.
+    _event_bus->unsubscribe<events::create_session_event>(_created);
+    _event_bus->unsubscribe<events::delete_sessions_event>(_deleted);
+    _event_bus->unsubscribe<events::reject_session_event>(_rejected);
+    _event_bus->unsubscribe<events::shed_session_event>(_shed);
+
     std::lock_guard<std::mutex> lock(_file_mutex);
     if (_file.is_open()) {
         _logger->info("Closing CDR file");
@@ -66,7 +79,10 @@ cdr_writer::~cdr_writer() {
     _logger->info("CDR writer destroyed");
 }
 
-void cdr_writer::write_record(const cdr_record &record) {
+void cdr_writer::write_records(std::span<const packed_imsi> imsis, cdr_action action) {
+    std::string timestamp = utility::get_current_timestamp();
+    std::string_view action_str = magic_enum::enum_name(action);
+
     std::lock_guard<std::mutex> lock(_file_mutex);
 
     if (not _file.is_open()) {
@@ -74,10 +90,10 @@ void cdr_writer::write_record(const cdr_record &record) {
         throw cdr_writer_exception("File is not open for writing");
     }
 
-    std::string_view action_str = magic_enum::enum_name(record.action);
-
-    _file << record.timestamp << ", " << record.imsi << ", " << action_str << '\n';
+    for (auto imsi: imsis) {
+        _file << timestamp << ", " << imsi.to_string() << ", " << action_str << '\n';
+    }
     _file.flush();
 
-    _logger->debug("CDR record written: " + record.imsi + " - " + std::string(action_str));
+    _logger->debug("CDR records written: " + std::to_string(imsis.size()) + " - " + std::string(action_str));
 }
@@ -3,19 +3,17 @@
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 
+#include <event_subscriber.hpp>
+#include <packed_imsi.hpp>
+
 class config;
 class event_bus;
 class logger;
 
-enum class cdr_action { created, deleted, rejected };
-
-struct cdr_record {
-    std::string timestamp;
-    std::string imsi;
-    cdr_action action;
-};
+enum class cdr_action { created, deleted, rejected, shed };
 
 class cdr_writer_exception : public std::runtime_error {
 public:
@@ -34,7 +32,8 @@ public:
     cdr_writer(cdr_writer &&) = delete;
     cdr_writer &operator=(cdr_writer &&) = delete;
 
-    void write_record(const cdr_record &record);
+    // One timestamp, one lock and one flush for the whole batch.
+    void write_records(std::span<const packed_imsi> imsis, cdr_action action);
 
 private:
     void setup();
@@ -46,4 +45,11 @@ private:
 
     std::ofstream _file;
     std::mutex _file_mutex;
+
+    // The handlers call back into this writer, so they are removed before it goes, whichever of it and the bus
+    // outlives the other.
+    subscription _created;
+    subscription _deleted;
+    subscription _rejected;
+    subscription _shed;
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <event_subscriber.hpp>
+
+// What a batch subscriber gets for each event: the lone parameter of a single-parameter event, the whole parameter
+// tuple otherwise.
+template<typename EventType>
+struct batch_element {
+    using type = typename EventType::param_type;
+};
+
+template<typename EventType>
+    requires(std::tuple_size_v<typename EventType::param_type> == 1)
+struct batch_element<EventType> {
+    using type = std::tuple_element_t<0, typename EventType::param_type>;
+};
+
+template<typename EventType>
+using batch_element_t = typename batch_element<EventType>::type;
+
+// A batch goes out once `max_events` have gathered, or `max_delay` after the previous one, whichever comes first.
+struct batch_options {
+    size_t max_events = 256;
+    std::chrono::milliseconds max_delay{10};
+};
+
+// Events of one type buffered for one batch subscriber. Publishers add under a lock of the subscriber's own; the
+// full buffer is swapped out and handed to `subscriber` without it.
+template<typename EventType>
+class event_batch {
+public:
+    using element = batch_element_t<EventType>;
+    using handler = std::function<void(std::span<const element>)>;
+
+    event_batch(handler on_batch, batch_options options, subscription_options delivery) :
+        subscriber([on_batch = std::move(on_batch)](const std::vector<element> &events) { on_batch(events); },
+                   std::move(delivery), EventType::name),
+        options(options), due(std::chrono::steady_clock::now() + options.max_delay) {
+        _pending.reserve(options.max_events);
+    }
+
+    event_batch(const event_batch &) = delete;
+    event_batch &operator=(const event_batch &) = delete;
+
+    // Returns the batch this event completes, or nothing while it is still filling up.
+    [[nodiscard]] std::vector<element> add(element value) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.push_back(std::move(value));
+        if (_pending.size() < options.max_events) {
+            return {};
+        }
+        return take_locked();
+    }
+
+    // Whatever has gathered so far, possibly nothing.
+    [[nodiscard]] std::vector<element> take() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return take_locked();
+    }
+
+    event_subscriber<std::vector<element>> subscriber;
+    const batch_options options;
+
+    // When the flusher next hands over this batch, however full; owned by the bus that flushes it.
+    std::chrono::steady_clock::time_point due;
+
+private:
+    std::vector<element> take_locked() {
+        if (_pending.empty()) {
+            return {};
+        }
+
+        std::vector<element> taken;
+        taken.reserve(options.max_events);
+        taken.swap(_pending);
+        return taken;
+    }
+
+    std::mutex _mutex;
+    std::vector<element> _pending;
+};
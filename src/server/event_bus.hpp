@@ -1,35 +1,150 @@
 #pragma once
 
-#include <any>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
-#include <typeindex>
-#include <unordered_map>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <event_batch.hpp>
+#include <event_subscriber.hpp>
+#include <snapshot_ptr.hpp>
 #include <thread_pool.hpp>
 
 #include <logger.hpp>
+#include <packed_imsi.hpp>
 
 namespace events {
     struct create_session_event {
-        using param_type = std::tuple<std::string>;
+        static constexpr std::string_view name = "create_session_event";
+        using param_type = std::tuple<packed_imsi>;
     };
 
-    struct delete_session_event {
-        using param_type = std::tuple<std::string>;
+    // Many sessions ended at once (expiry, graceful drain); one event, one CDR write, for the whole batch.
+    struct delete_sessions_event {
+        static constexpr std::string_view name = "delete_sessions_event";
+        using param_type = std::tuple<std::vector<packed_imsi>>;
     };
 
     struct reject_session_event {
-        using param_type = std::tuple<std::string>;
+        static constexpr std::string_view name = "reject_session_event";
+        using param_type = std::tuple<packed_imsi>;
+    };
+
+    // Refused because the session limit was reached; unlike a rejection it says nothing about the subscriber.
+    struct shed_session_event {
+        static constexpr std::string_view name = "shed_session_event";
+        using param_type = std::tuple<packed_imsi>;
     };
 
     struct graceful_shutdown_event {
+        static constexpr std::string_view name = "graceful_shutdown_event";
         using param_type = std::tuple<>;
     };
+
+    // Every event the bus carries. Each gets its own handler list inside the bus, so subscribing to or publishing
+    // anything not listed here fails to compile.
+    using registry = std::tuple<create_session_event, delete_sessions_event, reject_session_event, shed_session_event,
+                                graceful_shutdown_event>;
 } // namespace events
 
+// Handler lists for a fixed set of events, one typed list per event, picked at compile time.
+template<typename Registry>
+class event_handlers;
+
+template<typename... Events>
+class event_handlers<std::tuple<Events...>> {
+public:
+    template<typename EventType>
+    using subscriber = event_subscriber<typename EventType::param_type>;
+
+    // What publishers of one event see: the subscribers as of some subscribe(), never changed once published.
+    template<typename EventType>
+    struct view {
+        std::vector<subscriber<EventType> *> handlers;
+        std::vector<event_batch<EventType> *> batches;
+    };
+
+    // Subscribers of one event. The owning vectors change only under the bus's lock; every change publishes a fresh
+    // copy of the view, so publishers never lock. Subscribers are boxed and live as long as the list, so the
+    // addresses that views and queued deliveries hold stay valid.
+    template<typename EventType>
+    struct list {
+        std::vector<std::unique_ptr<subscriber<EventType>>> handlers;
+        std::vector<std::unique_ptr<event_batch<EventType>>> batches;
+        snapshot_ptr<view<EventType>> current{std::make_unique<const view<EventType>>()};
+
+        // Callers serialize.
+        void republish() {
+            auto next = std::make_unique<view<EventType>>();
+            next->handlers.reserve(handlers.size());
+            for (const auto &handler: handlers) {
+                next->handlers.push_back(handler.get());
+            }
+            next->batches.reserve(batches.size());
+            for (const auto &batch: batches) {
+                next->batches.push_back(batch.get());
+            }
+            current.publish(std::move(next));
+        }
+    };
+
+    template<typename EventType>
+    [[nodiscard]] list<EventType> &of() {
+        static_assert((std::is_same_v<EventType, Events> || ...), "event is not in events::registry");
+        return std::get<list<EventType>>(_lists);
+    }
+
+    // Calls visit(event_subscriber<T> &) for every subscriber of every event, batch subscribers included.
+    template<typename F>
+    void for_each_subscriber(F &&visit) {
+        std::apply(
+                [&](auto &...lists) {
+                    (
+                            [&](auto &list) {
+                                for (auto &handler: list.handlers) {
+                                    visit(*handler);
+                                }
+                                for (auto &batch: list.batches) {
+                                    visit(batch->subscriber);
+                                }
+                            }(lists),
+                            ...);
+                },
+                _lists);
+    }
+
+    // Calls visit(event_batch<E> &) for every batch subscription of every event.
+    template<typename F>
+    void for_each_batch(F &&visit) {
+        std::apply(
+                [&](auto &...lists) {
+                    (
+                            [&](auto &list) {
+                                for (auto &batch: list.batches) {
+                                    visit(*batch);
+                                }
+                            }(lists),
+                            ...);
+                },
+                _lists);
+    }
+
+private:
+    // A distinct type per event even where parameters match, so std::get can pick it out by type.
+    std::tuple<list<Events>...> _lists;
+};
+
 class event_bus {
 public:
     explicit event_bus(std::shared_ptr<thread_pool> thread_pool, std::shared_ptr<logger> logger) :
@@ -39,38 +154,195 @@ public:
     ~event_bus() { _logger->info("Event bus destroyed"); }
 
     void stop() {
+        if (_flusher.joinable()) {
+            _flusher.request_stop();
+            _flusher.join();
+        }
         if (_thread_pool) {
             _thread_pool.reset();
         }
     }
 
 public:
+    // Safe at any time, concurrently with publish(). Returns once the new subscriber is visible to every later
+    // publish(); until then it waits for publishes of this event in progress, so a publisher_thread handler must not
+    // subscribe to the event it handles.
     template<typename EventType, typename F>
-    void subscribe(F &&func) {
+    subscription subscribe(F &&func, subscription_options delivery = {}) {
         using ParamTuple = typename EventType::param_type;
-        auto type_index = std::type_index(typeid(EventType));
 
         auto wrapper = [f = std::forward<F>(func)](const ParamTuple &params) { std::apply(f, params); };
 
-        _handlers[type_index].emplace_back(std::function<void(const ParamTuple &)>(wrapper));
+        std::lock_guard<std::mutex> lock(_batch_mutex);
+        auto &list = _handlers.of<EventType>();
+        list.handlers.push_back(std::make_unique<event_handlers<events::registry>::subscriber<EventType>>(
+                std::move(wrapper), std::move(delivery), EventType::name));
+        list.republish();
+        return {.subscriber = list.handlers.back().get()};
+    }
+
+    // Buffers the events for this subscriber and hands them over as std::span<const batch_element_t<EventType>>, one
+    // delivery per batch, as `options` allows. Under the pool policy batches of one subscriber may overlap.
+    template<typename EventType, typename F>
+    subscription subscribe_batch(F &&on_batch, batch_options options = {}, subscription_options delivery = {}) {
+        std::lock_guard<std::mutex> lock(_batch_mutex);
+
+        auto &list = _handlers.of<EventType>();
+        list.batches.push_back(
+                std::make_unique<event_batch<EventType>>(std::forward<F>(on_batch), options, std::move(delivery)));
+        list.republish();
+
+        if (not _flusher.joinable()) {
+            _flusher = std::jthread([this](std::stop_token st) { flush_worker(st); });
+        }
+        // The new batch may be due before anything the flusher is waiting for.
+        _batches_added = true;
+        _batch_cv.notify_one();
+        return {.subscriber = list.batches.back().get()};
+    }
+
+    // For a subscriber that goes away before the bus: once this returns, neither publish(), the flusher nor a queued
+    // delivery reaches its handler again. A batch subscriber is first handed whatever is still buffered for it, on
+    // the calling thread. Call it at most once per subscription.
+    template<typename EventType>
+    void unsubscribe(subscription removed) {
+        std::unique_ptr<event_handlers<events::registry>::subscriber<EventType>> handler;
+        std::unique_ptr<event_batch<EventType>> batch;
+        {
+            std::lock_guard<std::mutex> lock(_batch_mutex);
+
+            auto &list = _handlers.of<EventType>();
+            handler = extract(list.handlers, removed.subscriber);
+            batch = extract(list.batches, removed.subscriber);
+            if (handler == nullptr && batch == nullptr) {
+                return;
+            }
+            // Waits for the publishes that may still see the old view; the flusher only finds batches in the list.
+            list.republish();
+        }
+
+        if (batch != nullptr) {
+            if (auto pending = batch->take(); not pending.empty()) {
+                batch->subscriber.call(pending);
+            }
+        }
+        // Destroying the subscriber waits for its deliveries still queued in the pool or on its own thread.
     }
 
     template<typename EventType, typename... Args>
     void publish(Args &&...args) {
         using ParamTuple = typename EventType::param_type;
-        auto type_index = std::type_index(typeid(EventType));
 
-        ParamTuple params = std::make_tuple(std::forward<Args>(args)...);
+        // Pins the subscribers as of now; a concurrent subscribe() applies from the next publish on.
+        auto list = _handlers.of<EventType>().current.read();
+        if (list->handlers.empty() && list->batches.empty()) {
+            return;
+        }
+
+        ParamTuple params(std::forward<Args>(args)...);
+
+        for (auto *batch: list->batches) {
+            if (auto full = batch->add(as_batch_element<EventType>(params)); not full.empty()) {
+                deliver(*batch, std::move(full));
+            }
+        }
 
-        for (const auto &handler_any: _handlers[type_index]) {
-            auto handler = std::any_cast<std::function<void(const ParamTuple &)>>(handler_any);
+        if (list->handlers.empty()) {
+            return;
+        }
 
-            _thread_pool->enqueue([handler, params]() { handler(params); });
+        // Each delivery refers to its subscriber in place; only the parameters travel with it, and the last
+        // delivery takes them over instead of a copy.
+        const auto &handlers = list->handlers;
+        for (size_t i = 0; i + 1 < handlers.size(); ++i) {
+            handlers[i]->deliver(params, *_thread_pool);
         }
+        handlers.back()->deliver(std::move(params), *_thread_pool);
+    }
+
+    // Hands every buffered event to its batch subscriber right away, on the calling thread; for a subscriber that is
+    // about to stop and must not leave events behind.
+    void flush() {
+        std::lock_guard<std::mutex> lock(_batch_mutex);
+
+        _handlers.for_each_batch([](auto &batch) {
+            if (auto pending = batch.take(); not pending.empty()) {
+                batch.subscriber.call(pending);
+            }
+        });
+    }
+
+    [[nodiscard]] std::vector<subscriber_stats> stats() {
+        std::lock_guard<std::mutex> lock(_batch_mutex);
+
+        std::vector<subscriber_stats> all;
+        _handlers.for_each_subscriber([&](const auto &subscriber) { all.push_back(subscriber.stats()); });
+        return all;
     }
 
 private:
+    template<typename T>
+    static std::unique_ptr<T> extract(std::vector<std::unique_ptr<T>> &owners, const void *target) {
+        auto found =
+                std::find_if(owners.begin(), owners.end(), [&](const auto &owner) { return owner.get() == target; });
+        if (found == owners.end()) {
+            return nullptr;
+        }
+        auto extracted = std::move(*found);
+        owners.erase(found);
+        return extracted;
+    }
+
+    template<typename EventType>
+    static batch_element_t<EventType> as_batch_element(const typename EventType::param_type &params) {
+        if constexpr (std::tuple_size_v<typename EventType::param_type> == 1) {
+            return std::get<0>(params);
+        } else {
+            return params;
+        }
+    }
+
+    template<typename EventType>
+    void deliver(event_batch<EventType> &batch, std::vector<batch_element_t<EventType>> events) {
+        batch.subscriber.deliver(std::move(events), *_thread_pool);
+    }
+
+    // Sends out every batch whose delay is up, however few events it holds, then sleeps until the next one is.
+    void flush_worker(std::stop_token st) {
+        std::unique_lock<std::mutex> lock(_batch_mutex);
+
+        while (not st.stop_requested()) {
+            auto now = std::chrono::steady_clock::now();
+            auto next = std::chrono::steady_clock::time_point::max();
+
+            _handlers.for_each_batch([&](auto &batch) {
+                if (batch.due <= now) {
+                    if (auto pending = batch.take(); not pending.empty()) {
+                        deliver(batch, std::move(pending));
+                    }
+                    batch.due = now + batch.options.max_delay;
+                }
+                next = std::min(next, batch.due);
+            });
+
+            _batches_added = false;
+            _batch_cv.wait_until(lock, st, next, [this]() { return _batches_added; });
+        }
+    }
+
+private:
+    // Declared first so that it is destroyed last: deliveries still queued in a pool this bus owns alone finish
+    // before their handlers go away.
+    event_handlers<events::registry> _handlers;
+
     std::shared_ptr<thread_pool> _thread_pool;
     std::shared_ptr<logger> _logger;
-    std::unordered_map<std::type_index, std::vector<std::any>> _handlers;
+
+    // Serializes changes to the subscriber lists and guards them against the flusher and stats(), and the flusher's
+    // schedule. publish() never takes it.
+    std::mutex _batch_mutex;
+    std::condition_variable_any _batch_cv;
+    bool _batches_added = false;
+    // Last, so that it stops before anything it uses is destroyed.
+    std::jthread _flusher;
 };
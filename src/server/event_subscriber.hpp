@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <mpsc_ring.hpp>
+#include <thread_pool.hpp>
+
+// Where a subscriber's handler runs.
+enum class delivery_policy {
+    publisher_thread, // called inside publish(); for handlers cheaper than a hand-off
+    pool,             // a task on the shared thread pool
+    dedicated_thread, // queued on a lock-free ring to a thread of the subscriber's own, in publish order
+};
+
+struct subscription_options {
+    delivery_policy delivery = delivery_policy::pool;
+    std::string name = "unnamed"; // how the subscriber shows up in statistics
+    size_t queue_capacity = 4096; // ring slots for dedicated_thread; publishers wait while it is full
+};
+
+// Names one subscriber for event_bus::unsubscribe().
+struct subscription {
+    const void *subscriber = nullptr;
+};
+
+// A snapshot of one subscriber's counters.
+struct subscriber_stats {
+    std::string name;
+    std::string_view event;
+    delivery_policy delivery = delivery_policy::pool;
+    uint64_t delivered = 0;       // handler calls
+    uint64_t failed = 0;          // handler calls that threw
+    uint64_t queue_depth = 0;     // deliveries handed off but not yet started
+    uint64_t max_queue_depth = 0;
+    uint64_t total_handler_ns = 0;
+    uint64_t max_handler_ns = 0;
+    uint64_t full_waits = 0;      // publishes that found the ring full and had to wait
+};
+
+// One subscription: its handler, the policy it is delivered by and the counters kept about it. `Item` is what a
+// delivery carries: an event's parameter tuple, or a batch of events.
+template<typename Item>
+class event_subscriber {
+public:
+    using handler = std::function<void(const Item &)>;
+
+    event_subscriber(handler on_event, subscription_options options, std::string_view event) :
+        _handler(std::move(on_event)), _options(std::move(options)), _event(event) {
+        if (_options.delivery == delivery_policy::dedicated_thread) {
+            _ring = std::make_unique<mpsc_ring<Item>>(_options.queue_capacity);
+            _consumer = std::jthread([this](std::stop_token st) { consume(st); });
+        }
+    }
+
+    // A dedicated thread delivers what is already queued before it exits; pool tasks already handed out are waited
+    // for, since they refer to this subscriber.
+    ~event_subscriber() {
+        if (_consumer.joinable()) {
+            _consumer.request_stop();
+            wake();
+            _consumer.join();
+        }
+        while (_in_pool.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    event_subscriber(const event_subscriber &) = delete;
+    event_subscriber &operator=(const event_subscriber &) = delete;
+
+    void deliver(Item item, thread_pool &pool) {
+        switch (_options.delivery) {
+            case delivery_policy::publisher_thread:
+                call(item);
+                return;
+
+            case delivery_policy::pool:
+                queued();
+                _in_pool.fetch_add(1, std::memory_order_relaxed);
+                pool.enqueue([this, item = std::move(item)]() {
+                    _queue_depth.fetch_sub(1, std::memory_order_relaxed);
+                    call(item);
+                    // The task's last touch of this subscriber.
+                    _in_pool.fetch_sub(1, std::memory_order_release);
+                });
+                return;
+
+            case delivery_policy::dedicated_thread:
+                push(std::move(item));
+                return;
+        }
+    }
+
+    // Runs the handler on the calling thread. Exceptions are counted and swallowed, as a pool task's would be.
+    void call(const Item &item) {
+        auto started_at = std::chrono::steady_clock::now();
+        try {
+            _handler(item);
+        } catch (const std::exception &) {
+            _failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started_at)
+                        .count());
+
+        _delivered.fetch_add(1, std::memory_order_relaxed);
+        _total_handler_ns.fetch_add(elapsed, std::memory_order_relaxed);
+        raise(_max_handler_ns, elapsed);
+    }
+
+    [[nodiscard]] subscriber_stats stats() const {
+        return {.name = _options.name,
+                .event = _event,
+                .delivery = _options.delivery,
+                .delivered = _delivered.load(std::memory_order_relaxed),
+                .failed = _failed.load(std::memory_order_relaxed),
+                .queue_depth = _queue_depth.load(std::memory_order_relaxed),
+                .max_queue_depth = _max_queue_depth.load(std::memory_order_relaxed),
+                .total_handler_ns = _total_handler_ns.load(std::memory_order_relaxed),
+                .max_handler_ns = _max_handler_ns.load(std::memory_order_relaxed),
+                .full_waits = _full_waits.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static void raise(std::atomic<uint64_t> &maximum, uint64_t value) {
+        uint64_t current = maximum.load(std::memory_order_relaxed);
+        while (value > current && not maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void queued() { raise(_max_queue_depth, _queue_depth.fetch_add(1, std::memory_order_relaxed) + 1); }
+
+    void push(Item item) {
+        queued();
+
+        if (not _ring->try_push(item)) {
+            _full_waits.fetch_add(1, std::memory_order_relaxed);
+            do {
+                wake();
+                std::this_thread::yield();
+            } while (not _ring->try_push(item));
+        }
+
+        // The claim in try_push() and this load pair with the store and size() in consume(), all seq_cst: either the
+        // consumer sees this item before it sleeps, or we see that it is asleep.
+        if (_sleeping.load(std::memory_order_seq_cst)) {
+            wake();
+        }
+    }
+
+    void wake() {
+        _wakeups.fetch_add(1, std::memory_order_release);
+        _wakeups.notify_one();
+    }
+
+    void consume(std::stop_token st) {
+        Item item;
+        while (true) {
+            if (_ring->try_pop(item)) {
+                _queue_depth.fetch_sub(1, std::memory_order_relaxed);
+                call(item);
+                continue;
+            }
+            if (st.stop_requested()) {
+                return;
+            }
+
+            uint32_t seen = _wakeups.load(std::memory_order_acquire);
+            _sleeping.store(true, std::memory_order_seq_cst);
+            if (_ring->size() == 0 && not st.stop_requested()) {
+                _wakeups.wait(seen, std::memory_order_acquire);
+            }
+            _sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    handler _handler;
+    subscription_options _options;
+    std::string_view _event;
+
+    std::atomic<uint64_t> _delivered{0};
+    std::atomic<uint64_t> _failed{0};
+    std::atomic<uint64_t> _queue_depth{0};
+    std::atomic<uint64_t> _max_queue_depth{0};
+    std::atomic<uint64_t> _total_handler_ns{0};
+    std::atomic<uint64_t> _max_handler_ns{0};
+    std::atomic<uint64_t> _full_waits{0};
+    // Pool tasks handed out and not yet finished.
+    std::atomic<uint64_t> _in_pool{0};
+
+    std::unique_ptr<mpsc_ring<Item>> _ring;
+    std::atomic<uint32_t> _wakeups{0};
+    std::atomic<bool> _sleeping{false};
+    // Last, so that it stops before the ring and counters it uses are destroyed.
+    std::jthread _consumer;
+};
@@ -1,5 +1,6 @@
 #include <http_server.hpp>
 
+#include <blacklist_file.hpp>
 #include <config.hpp>
 #include <event_bus.hpp>
 #include <logger.hpp>
@@ -7,6 +8,9 @@
 
 #include <regex>
 
+#include <magic_enum/magic_enum.hpp>
+#include <nlohmann/json.hpp>
+
 http_server::http_server(std::shared_ptr<config> config, std::shared_ptr<session_manager> session_manager,
                          std::shared_ptr<event_bus> event_bus, std::shared_ptr<logger> logger) :
     _config(std::move(config)), _session_manager(std::move(session_manager)), _event_bus(std::move(event_bus)),
@@ -47,6 +51,19 @@ void http_server::setup_routes() {
 
     _server->Post("/stop", [this](const httplib::Request &req, httplib::Response &res) { handle_stop(req, res); });
 
+    _server->Get("/drain_status",
+                 [this](const httplib::Request &req, httplib::Response &res) { handle_drain_status(req, res); });
+
+    _server->Get("/event_stats",
+                 [this](const httplib::Request &req, httplib::Response &res) { handle_event_stats(req, res); });
+
+    _server->Post("/blacklist/add",
+                  [this](const httplib::Request &req, httplib::Response &res) { handle_blacklist_add(req, res); });
+    _server->Post("/blacklist/remove",
+                  [this](const httplib::Request &req, httplib::Response &res) { handle_blacklist_remove(req, res); });
+    _server->Put("/blacklist",
+                 [this](const httplib::Request &req, httplib::Response &res) { handle_blacklist_replace(req, res); });
+
     _server->set_error_handler([this](const httplib::Request &req, httplib::Response &res) {
         _logger->warning("Unknown HTTP endpoint: " + req.method + " " + req.path);
         res.status = 404;
@@ -92,7 +109,7 @@ void http_server::handle_check_subscriber(const httplib::Request &req, httplib::
 
         _logger->debug("Checking session status for IMSI: " + imsi);
 
-        bool is_active = _session_manager->has_active_session(imsi);
+        bool is_active = _session_manager->has_active_session(packed_imsi::from_string(imsi).value());
         std::string response = is_active ? "active" : "not active";
 
         _logger->info("Session status for IMSI " + imsi + ": " + response);
@@ -127,6 +144,145 @@ void http_server::handle_stop(const httplib::Request &req, httplib::Response &re
     }
 }
 
+void http_server::handle_drain_status(const httplib::Request &req, httplib::Response &res) {
+    _logger->debug("Received drain_status request from " + req.remote_addr);
+
+    try {
+        drain_progress progress = _session_manager->get_drain_progress();
+
+        nlohmann::json status = {
+                {"state", magic_enum::enum_name(progress.status)},
+                {"total", progress.total},
+                {"released", progress.released},
+                {"remaining", progress.total - progress.released},
+                {"target_rate", progress.target_rate},
+                {"achieved_rate", progress.achieved_rate},
+        };
+
+        res.status = 200;
+        res.set_content(status.dump(), "application/json");
+
+    } catch (const std::exception &e) {
+        _logger->error("Error processing drain_status request: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("Internal Server Error", "text/plain");
+    }
+}
+
+void http_server::handle_event_stats(const httplib::Request &req, httplib::Response &res) {
+    _logger->debug("Received event_stats request from " + req.remote_addr);
+
+    try {
+        nlohmann::json subscribers = nlohmann::json::array();
+        for (const auto &stats: _event_bus->stats()) {
+            subscribers.push_back({
+                    {"name", stats.name},
+                    {"event", stats.event},
+                    {"delivery", magic_enum::enum_name(stats.delivery)},
+                    {"delivered", stats.delivered},
+                    {"failed", stats.failed},
+                    {"queue_depth", stats.queue_depth},
+                    {"max_queue_depth", stats.max_queue_depth},
+                    {"avg_handler_ns", stats.delivered == 0 ? 0 : stats.total_handler_ns / stats.delivered},
+                    {"max_handler_ns", stats.max_handler_ns},
+                    {"full_waits", stats.full_waits},
+            });
+        }
+
+        res.status = 200;
+        res.set_content(subscribers.dump(), "application/json");
+    } catch (const std::exception &e) {
+        _logger->error("Error processing event_stats request: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("Internal Server Error", "text/plain");
+    }
+}
+
+void http_server::handle_blacklist_add(const httplib::Request &req, httplib::Response &res) {
+    _logger->info("Received blacklist add request from " + req.remote_addr);
+
+    try {
+        auto imsis = parse_blacklist_body(req, res);
+        if (!imsis.has_value()) {
+            return;
+        }
+
+        size_t added = _session_manager->add_to_blacklist(std::move(imsis.value()));
+
+        res.status = 200;
+        res.set_content("added " + std::to_string(added) + ", blacklist size " +
+                                std::to_string(_session_manager->blacklist_size()),
+                        "text/plain");
+
+    } catch (const std::exception &e) {
+        _logger->error("Error processing blacklist add request: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("Internal Server Error", "text/plain");
+    }
+}
+
+void http_server::handle_blacklist_remove(const httplib::Request &req, httplib::Response &res) {
+    _logger->info("Received blacklist remove request from " + req.remote_addr);
+
+    try {
+        auto imsis = parse_blacklist_body(req, res);
+        if (!imsis.has_value()) {
+            return;
+        }
+
+        size_t removed = _session_manager->remove_from_blacklist(std::move(imsis.value()));
+
+        res.status = 200;
+        res.set_content("removed " + std::to_string(removed) + ", blacklist size " +
+                                std::to_string(_session_manager->blacklist_size()),
+                        "text/plain");
+
+    } catch (const std::exception &e) {
+        _logger->error("Error processing blacklist remove request: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("Internal Server Error", "text/plain");
+    }
+}
+
+void http_server::handle_blacklist_replace(const httplib::Request &req, httplib::Response &res) {
+    _logger->info("Received blacklist replace request from " + req.remote_addr);
+
+    try {
+        auto imsis = parse_blacklist_body(req, res);
+        if (!imsis.has_value()) {
+            return;
+        }
+
+        _session_manager->replace_blacklist(std::move(imsis.value()));
+
+        res.status = 200;
+        res.set_content("blacklist size " + std::to_string(_session_manager->blacklist_size()), "text/plain");
+
+    } catch (const std::exception &e) {
+        _logger->error("Error processing blacklist replace request: " + std::string(e.what()));
+        res.status = 500;
+        res.set_content("Internal Server Error", "text/plain");
+    }
+}
+
+std::optional<std::vector<packed_imsi>> http_server::parse_blacklist_body(const httplib::Request &req,
+                                                                          httplib::Response &res) {
+    // Same format as blacklist_file, so a bulk replacement may be as large as the file itself.
+    auto contents = parse_blacklist(req.body, std::max(1u, std::thread::hardware_concurrency()));
+
+    if (contents.invalid_lines != 0) {
+        _logger->warning("Rejecting blacklist update with " + std::to_string(contents.invalid_lines) +
+                         " invalid IMSIs");
+        res.status = 400;
+        res.set_content("Bad Request: " + std::to_string(contents.invalid_lines) +
+                                " lines are not IMSIs of 1 to 15 digits",
+                        "text/plain");
+        return std::nullopt;
+    }
+
+    return std::move(contents.imsis);
+}
+
 void http_server::start() {
     if (_running.load()) {
         _logger->warning("HTTP server is already running");
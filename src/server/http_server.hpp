@@ -2,12 +2,16 @@
 
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <httplib.h>
 
+#include <packed_imsi.hpp>
+
 class config;
 class session_manager;
 class event_bus;
@@ -38,6 +42,15 @@ private:
 
     void handle_check_subscriber(const httplib::Request &req, httplib::Response &res);
     void handle_stop(const httplib::Request &req, httplib::Response &res);
+    void handle_drain_status(const httplib::Request &req, httplib::Response &res);
+    void handle_event_stats(const httplib::Request &req, httplib::Response &res);
+    void handle_blacklist_add(const httplib::Request &req, httplib::Response &res);
+    void handle_blacklist_remove(const httplib::Request &req, httplib::Response &res);
+    void handle_blacklist_replace(const httplib::Request &req, httplib::Response &res);
+
+    // Reads one IMSI per line from the request body; answers 400 and returns nothing if any line is invalid.
+    std::optional<std::vector<packed_imsi>> parse_blacklist_body(const httplib::Request &req,
+                                                                 httplib::Response &res);
 
 private:
     std::shared_ptr<config> _config;
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <io_uring_ring.hpp>
+
+#if !defined(IORING_RECV_MULTISHOT) || !defined(IORING_SETUP_SINGLE_ISSUER)
+#error "linux/io_uring.h is too old: multishot recvmsg and provided buffer rings are required"
+#endif
+
+io_uring_ring::io_uring_ring(uint32_t entries) {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+
+    _ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (_ring_fd < 0) {
+        throw io_uring_exception("io_uring_setup failed: " + std::string(strerror(errno)));
+    }
+
+    if (not(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        cleanup();
+        throw io_uring_exception("kernel lacks IORING_FEAT_SINGLE_MMAP");
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    _ring_size = std::max(sq_size, cq_size);
+
+    _ring_ptr = mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                     IORING_OFF_SQ_RING);
+    if (_ring_ptr == MAP_FAILED) {
+        _ring_ptr = nullptr;
+        cleanup();
+        throw io_uring_exception("Failed to map io_uring rings: " + std::string(strerror(errno)));
+    }
+
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        cleanup();
+        throw io_uring_exception("Failed to map io_uring SQEs: " + std::string(strerror(errno)));
+    }
+    _sqes = static_cast<io_uring_sqe *>(sqes);
+
+    auto *ring = static_cast<uint8_t *>(_ring_ptr);
+
+    _sq_head = reinterpret_cast<uint32_t *>(ring + params.sq_off.head);
+    _sq_tail = reinterpret_cast<uint32_t *>(ring + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<uint32_t *>(ring + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+
+    auto *sq_array = reinterpret_cast<uint32_t *>(ring + params.sq_off.array);
+    for (uint32_t i = 0; i < _sq_entries; ++i) {
+        sq_array[i] = i;
+    }
+    _sqe_tail = _sqe_submitted = *_sq_tail;
+
+    _cq_head = reinterpret_cast<uint32_t *>(ring + params.cq_off.head);
+    _cq_tail = reinterpret_cast<uint32_t *>(ring + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<uint32_t *>(ring + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+}
+
+io_uring_ring::~io_uring_ring() { cleanup(); }
+
+void io_uring_ring::cleanup() {
+    if (_buf_ring != nullptr) {
+        munmap(_buf_ring, _buf_ring_size);
+        _buf_ring = nullptr;
+    }
+    if (_sqes != nullptr) {
+        munmap(_sqes, _sqes_size);
+        _sqes = nullptr;
+    }
+    if (_ring_ptr != nullptr) {
+        munmap(_ring_ptr, _ring_size);
+        _ring_ptr = nullptr;
+    }
+    if (_ring_fd != -1) {
+        close(_ring_fd);
+        _ring_fd = -1;
+    }
+}
+
+io_uring_sqe *io_uring_ring::get_sqe() {
+    if (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+        submit_and_wait(0);
+
+        if (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe *sqe = &_sqes[_sqe_tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sqe_tail++;
+    return sqe;
+}
+
+int io_uring_ring::submit_and_wait(uint32_t wait_nr) {
+    __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+
+    uint32_t to_submit = _sqe_tail - _sqe_submitted;
+    uint32_t flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    int submitted;
+    do {
+        submitted = static_cast<int>(syscall(__NR_io_uring_enter, _ring_fd, to_submit, wait_nr, flags, nullptr, 0));
+    } while (submitted < 0 && errno == EINTR && wait_nr == 0);
+
+    if (submitted < 0) {
+        return -errno;
+    }
+
+    _sqe_submitted += static_cast<uint32_t>(submitted);
+    return submitted;
+}
+
+void io_uring_ring::register_buffer_ring(uint16_t group_id, uint32_t entries) {
+    if (entries == 0 || entries > 32768 || (entries & (entries - 1)) != 0) {
+        throw io_uring_exception("Buffer ring size must be a power of two up to 32768");
+    }
+
+    _buf_ring_size = entries * sizeof(io_uring_buf);
+    void *ptr = mmap(nullptr, _buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        throw io_uring_exception("Failed to allocate buffer ring: " + std::string(strerror(errno)));
+    }
+    _buf_ring = static_cast<io_uring_buf_ring *>(ptr);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(ptr);
+    reg.ring_entries = entries;
+    reg.bgid = group_id;
+
+    if (syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int error = errno;
+        munmap(_buf_ring, _buf_ring_size);
+        _buf_ring = nullptr;
+        throw io_uring_exception("IORING_REGISTER_PBUF_RING failed: " + std::string(strerror(error)));
+    }
+
+    _buf_group_id = group_id;
+    _buf_mask = entries - 1;
+    _buf_tail = 0;
+    _buf_pending = 0;
+}
+
+void io_uring_ring::provide_buffer(void *addr, uint32_t len, uint16_t buffer_id) {
+    // bufs[] is declared through __DECLARE_FLEX_ARRAY, whose empty struct shifts it in C++
+    auto *bufs = reinterpret_cast<io_uring_buf *>(_buf_ring);
+    io_uring_buf &buf = bufs[(_buf_tail + _buf_pending) & _buf_mask];
+    buf.addr = reinterpret_cast<uint64_t>(addr);
+    buf.len = len;
+    buf.bid = buffer_id;
+    _buf_pending++;
+}
+
+void io_uring_ring::commit_buffers() {
+    if (_buf_pending == 0) {
+        return;
+    }
+
+    _buf_tail = static_cast<uint16_t>(_buf_tail + _buf_pending);
+    _buf_pending = 0;
+    __atomic_store_n(&_buf_ring->tail, _buf_tail, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <string>
+
+class io_uring_exception : public std::runtime_error {
+public:
+    explicit io_uring_exception(const std::string &message) :
+        std::runtime_error("io_uring_exception: " + message) {}
+};
+
+class io_uring_ring {
+public:
+    explicit io_uring_ring(uint32_t entries);
+    ~io_uring_ring();
+
+    io_uring_ring(const io_uring_ring &) = delete;
+    io_uring_ring &operator=(const io_uring_ring &) = delete;
+    io_uring_ring(io_uring_ring &&) = delete;
+    io_uring_ring &operator=(io_uring_ring &&) = delete;
+
+    [[nodiscard]] io_uring_sqe *get_sqe();
+    int submit_and_wait(uint32_t wait_nr);
+
+    template<typename F>
+    uint32_t for_each_cqe(F &&func) {
+        uint32_t head = *_cq_head;
+        uint32_t tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+
+        for (uint32_t i = head; i != tail; ++i) {
+            func(_cqes[i & _cq_mask]);
+        }
+
+        __atomic_store_n(_cq_head, tail, __ATOMIC_RELEASE);
+        return tail - head;
+    }
+
+    void register_buffer_ring(uint16_t group_id, uint32_t entries);
+    void provide_buffer(void *addr, uint32_t len, uint16_t buffer_id);
+    void commit_buffers();
+
+    [[nodiscard]] uint32_t pending_submissions() const { return _sqe_tail - _sqe_submitted; }
+
+private:
+    void cleanup();
+
+private:
+    int _ring_fd = -1;
+
+    void *_ring_ptr = nullptr;
+    size_t _ring_size = 0;
+    io_uring_sqe *_sqes = nullptr;
+    size_t _sqes_size = 0;
+
+    uint32_t *_sq_head = nullptr;
+    uint32_t *_sq_tail = nullptr;
+    uint32_t _sq_mask = 0;
+    uint32_t _sq_entries = 0;
+    uint32_t _sqe_tail = 0;
+    uint32_t _sqe_submitted = 0;
+
+    uint32_t *_cq_head = nullptr;
+    uint32_t *_cq_tail = nullptr;
+    uint32_t _cq_mask = 0;
+    io_uring_cqe *_cqes = nullptr;
+
+    io_uring_buf_ring *_buf_ring = nullptr;
+    size_t _buf_ring_size = 0;
+    uint16_t _buf_group_id = 0;
+    uint32_t _buf_mask = 0;
+    uint16_t _buf_tail = 0;
+    uint16_t _buf_pending = 0;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for many producers and one consumer (Vyukov's bounded queue). Every cell carries a
+// sequence number that tells whose turn it is: producers claim a cell by advancing the tail with a CAS, fill it and
+// publish it by bumping its sequence; the consumer takes cells in order and hands them back a lap ahead. Producers
+// never wait for each other beyond the CAS, and nothing allocates after construction.
+template<typename T>
+class mpsc_ring {
+public:
+    // Rounds `capacity` up to a power of two.
+    explicit mpsc_ring(size_t capacity) :
+        _mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), _cells(std::make_unique<cell[]>(_mask + 1)) {
+        for (size_t i = 0; i <= _mask; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_ring(const mpsc_ring &) = delete;
+    mpsc_ring &operator=(const mpsc_ring &) = delete;
+
+    // Safe from any thread. Leaves `value` untouched and returns false when the ring is full.
+    [[nodiscard]] bool try_push(T &value) {
+        size_t position = _tail.load(std::memory_order_relaxed);
+        while (true) {
+            cell &target = _cells[position & _mask];
+            size_t sequence = target.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (lag == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                    target.value = std::move(value);
+                    target.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                // The cell still holds the item from a lap ago: full.
+                return false;
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only.
+    [[nodiscard]] bool try_pop(T &out) {
+        size_t position = _head.load(std::memory_order_relaxed);
+        cell &source = _cells[position & _mask];
+        if (source.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+
+        out = std::move(source.value);
+        source.value = T{};
+        source.sequence.store(position + _mask + 1, std::memory_order_release);
+        _head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Items claimed but not yet taken; approximate while producers or the consumer are active. The tail is claimed
+    // and read here sequentially consistent (free on x86, where the CAS is a full barrier anyway), so a consumer can
+    // publish "going to sleep" in a seq_cst store, check size() and be sure any producer it misses sees that store.
+    [[nodiscard]] size_t size() const {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_seq_cst);
+        return tail > head ? tail - head : 0;
+    }
+
+    [[nodiscard]] size_t capacity() const { return _mask + 1; }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct cell {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    const size_t _mask;
+    std::unique_ptr<cell[]> _cells;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head{0};
+};
@@ -0,0 +1,72 @@
+#include <netinet/udp.h>
+
+#include <packet_filter.hpp>
+
+#include <utility.hpp>
+
+namespace packet_filter {
+
+    namespace {
+        constexpr uint32_t STEERING_HASH_BYTES = (utility::MAX_IMSI_DIGITS + 1) / 2;
+        constexpr uint32_t STEERING_HASH_MULTIPLIER = 31;
+    } // namespace
+
+    std::vector<sock_filter> malformed_program() {
+        // A socket filter on a UDP socket sees the datagram starting at the UDP header, so both the length and
+        // the IMSI type offset are shifted by sizeof(udphdr).
+        constexpr uint32_t min_size = sizeof(udphdr) + utility::MIN_IMSI_PACKET_SIZE;
+        constexpr uint32_t max_size = sizeof(udphdr) + utility::MAX_IMSI_PACKET_SIZE;
+
+        return {
+                BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0),
+                BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K, min_size, 0, 4),
+                BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, max_size, 3, 0),
+                BPF_STMT(BPF_LD | BPF_B | BPF_ABS, sizeof(udphdr)),
+                BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, utility::IMSI_TYPE, 0, 1),
+                BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF),
+                BPF_STMT(BPF_RET | BPF_K, 0),
+        };
+    }
+
+    std::vector<sock_filter> steering_program(uint32_t groups) {
+        // The reuseport program runs with the UDP header already pulled, so offsets are payload offsets.
+        // Classic BPF has no loops: every BCD byte is an unrolled "hash = hash * 31 + byte" step that is
+        // skipped to the end once the datagram runs out.
+        constexpr uint32_t step_size = 8;
+
+        std::vector<sock_filter> code;
+        code.push_back(BPF_STMT(BPF_LD | BPF_IMM, 0));
+        code.push_back(BPF_STMT(BPF_ST, 0));
+
+        for (uint32_t i = 0; i < STEERING_HASH_BYTES; ++i) {
+            auto offset = static_cast<uint32_t>(utility::IMSI_HEADER_SIZE) + i;
+            auto remaining_steps = static_cast<uint8_t>((STEERING_HASH_BYTES - i - 1) * step_size + 6);
+
+            code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_LEN, 0));
+            code.push_back(BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, offset, 0, remaining_steps));
+            code.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, offset));
+            code.push_back(BPF_STMT(BPF_MISC | BPF_TAX, 0));
+            code.push_back(BPF_STMT(BPF_LD | BPF_MEM, 0));
+            code.push_back(BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, STEERING_HASH_MULTIPLIER));
+            code.push_back(BPF_STMT(BPF_ALU | BPF_ADD | BPF_X, 0));
+            code.push_back(BPF_STMT(BPF_ST, 0));
+        }
+
+        code.push_back(BPF_STMT(BPF_LD | BPF_MEM, 0));
+        code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, groups));
+        code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+        return code;
+    }
+
+    uint32_t steering_index(std::span<const uint8_t> packet, uint32_t groups) {
+        uint32_t hash = 0;
+        for (size_t i = utility::IMSI_HEADER_SIZE;
+             i < packet.size() && i < utility::IMSI_HEADER_SIZE + STEERING_HASH_BYTES; ++i) {
+            hash = hash * STEERING_HASH_MULTIPLIER + packet[i];
+        }
+
+        return hash % groups;
+    }
+
+} // namespace packet_filter
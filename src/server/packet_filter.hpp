@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <linux/filter.h>
+
+namespace packet_filter {
+    // Socket filter that keeps only datagrams shaped like an IMSI request (SO_ATTACH_FILTER).
+    [[nodiscard]] std::vector<sock_filter> malformed_program();
+
+    // Reuseport group program that picks a socket by hashing the BCD IMSI bytes (SO_ATTACH_REUSEPORT_CBPF).
+    [[nodiscard]] std::vector<sock_filter> steering_program(uint32_t groups);
+
+    // User-space mirror of steering_program: index of the socket a datagram is steered to.
+    [[nodiscard]] uint32_t steering_index(std::span<const uint8_t> packet, uint32_t groups);
+} // namespace packet_filter
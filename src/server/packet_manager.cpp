@@ -1,5 +1,6 @@
 #include <string>
 #include <thread>
+#include <utility>
 
 #include <packet_manager.hpp>
 
@@ -22,39 +23,64 @@ packet_manager::packet_manager(std::shared_ptr<config> config, std::shared_ptr<e
 
 packet_manager::~packet_manager() { _logger->info("Packet manager is destroyed"); }
 
-std::expected<std::string, packet_manager_error> packet_manager::handle_packet(Packet packet) {
-    _logger->debug("Handling packet of size: " + std::to_string(packet.size()));
+// Per-request outcomes are logged at debug level only, and only built when that level is on: at the default level
+// the request path must not allocate, and the CDR file already records every creation and rejection.
+std::expected<packet_result, packet_manager_error> packet_manager::handle_packet(Packet packet) {
+    bool debug_enabled = _logger->is_enabled(logger::log_level::debug);
 
-    std::expected<std::string, utility::decode_error> imsi = utility::decode_imsi_from_bcd(packet);
+    if (debug_enabled) {
+        _logger->debug("Handling packet of size: " + std::to_string(packet.size()));
+    }
+
+    std::expected<packed_imsi, utility::decode_error> decoded = utility::decode_imsi_from_bcd(packet);
 
-    if (not imsi.has_value()) {
-        std::string error_msg = "Failed to parse IMSI: " + std::string(magic_enum::enum_name(imsi.error()));
-        _logger->warning(error_msg);
+    if (not decoded.has_value()) {
+        if (debug_enabled) {
+            _logger->debug("Failed to parse IMSI: " + std::string(magic_enum::enum_name(decoded.error())));
+        }
 
         return std::unexpected(packet_manager_error::packet_parsing_failed);
     }
 
-    std::string imsi_str = imsi.value();
-    _logger->debug("Extracted IMSI: " + imsi_str);
+    packed_imsi imsi = decoded.value();
+    if (debug_enabled) {
+        _logger->debug("Extracted IMSI: " + imsi.to_string());
+    }
 
-    if (_session_manager->has_blacklist_session(imsi_str)) {
-        _logger->info("IMSI " + imsi_str + " is in blacklist, rejecting session");
+    if (_session_manager->has_blacklist_session(imsi)) {
+        if (debug_enabled) {
+            _logger->debug("IMSI " + imsi.to_string() + " is in blacklist, rejecting session");
+        }
 
-        _event_bus->publish<events::reject_session_event>(imsi_str);
-        return "rejected";
+        _event_bus->publish<events::reject_session_event>(imsi);
+        return packet_result::rejected;
     }
 
-    std::shared_ptr<session> result = _session_manager->create_session(imsi_str);
+    switch (_session_manager->create_session(imsi)) {
+        case create_session_result::created:
+            if (debug_enabled) {
+                _logger->debug("Session created for IMSI: " + imsi.to_string());
+            }
 
-    if (result) {
-        _logger->info("Session created for IMSI: " + imsi_str);
+            _event_bus->publish<events::create_session_event>(imsi);
+            return packet_result::created;
 
-        _event_bus->publish<events::create_session_event>(imsi_str);
-        return "created";
-    } else {
-        _logger->warning("Failed to create session for IMSI: " + imsi_str + " (session already exists)");
+        case create_session_result::already_exists:
+            if (debug_enabled) {
+                _logger->debug("Failed to create session for IMSI: " + imsi.to_string() +
+                               " (session already exists)");
+            }
 
-        _event_bus->publish<events::reject_session_event>(imsi_str);
-        return "rejected";
+            _event_bus->publish<events::reject_session_event>(imsi);
+            return packet_result::rejected;
+
+        case create_session_result::capacity_exceeded:
+            _logger->warning("Failed to create session for IMSI: " + imsi.to_string() + " (capacity exceeded)");
+
+            // Not a verdict on the subscriber, so the reply is an error the client may retry on, not "rejected".
+            _event_bus->publish<events::shed_session_event>(imsi);
+            return std::unexpected(packet_manager_error::capacity_exceeded);
     }
+
+    std::unreachable();
 }
@@ -15,8 +15,11 @@ class logger;
 
 enum class packet_manager_error {
     packet_parsing_failed,
+    capacity_exceeded,
 };
 
+enum class packet_result { created, rejected };
+
 class packet_manager {
 public:
     using Packet = std::span<const uint8_t>;
@@ -26,7 +29,7 @@ public:
     ~packet_manager();
 
 public:
-    std::expected<std::string, packet_manager_error> handle_packet(Packet packet);
+    std::expected<packet_result, packet_manager_error> handle_packet(Packet packet);
 
 private:
     std::shared_ptr<config> _config;
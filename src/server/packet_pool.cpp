@@ -0,0 +1,27 @@
+#include <packet_pool.hpp>
+
+#include <stdexcept>
+
+packet_pool::packet_pool(size_t slots_num, size_t slot_size) :
+    _slots_num(slots_num), _slot_size(slot_size), _slab(slots_num * slot_size) {
+    if (slots_num == 0 || slots_num >= invalid_slot) {
+        throw std::invalid_argument("packet_pool: invalid number of slots");
+    }
+
+    _free_slots.reserve(slots_num);
+    for (size_t i = slots_num; i > 0; --i) {
+        _free_slots.push_back(static_cast<slot_id>(i - 1));
+    }
+}
+
+packet_pool::slot_id packet_pool::acquire() {
+    if (_free_slots.empty()) {
+        return invalid_slot;
+    }
+
+    slot_id slot = _free_slots.back();
+    _free_slots.pop_back();
+    return slot;
+}
+
+void packet_pool::release(slot_id slot) { _free_slots.push_back(slot); }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+class packet_pool {
+public:
+    using slot_id = uint32_t;
+    static constexpr slot_id invalid_slot = std::numeric_limits<slot_id>::max();
+
+    packet_pool(size_t slots_num, size_t slot_size);
+
+    packet_pool(const packet_pool &) = delete;
+    packet_pool &operator=(const packet_pool &) = delete;
+
+    [[nodiscard]] slot_id acquire();
+    void release(slot_id slot);
+
+    [[nodiscard]] std::span<uint8_t> buffer(slot_id slot) {
+        return {_slab.data() + static_cast<size_t>(slot) * _slot_size, _slot_size};
+    }
+    [[nodiscard]] std::span<const uint8_t> data(slot_id slot, size_t offset, size_t size) const {
+        return {_slab.data() + static_cast<size_t>(slot) * _slot_size + offset, size};
+    }
+
+    [[nodiscard]] size_t capacity() const { return _slots_num; }
+    [[nodiscard]] size_t available() const { return _free_slots.size(); }
+    [[nodiscard]] size_t slot_size() const { return _slot_size; }
+
+private:
+    size_t _slots_num;
+    size_t _slot_size;
+
+    std::vector<uint8_t> _slab;
+    std::vector<slot_id> _free_slots;
+};
@@ -0,0 +1,47 @@
+#include <new>
+#include <sys/mman.h>
+
+#include <page_allocator.hpp>
+
+namespace page_memory {
+
+    namespace {
+        constexpr size_t PAGE_BYTES = 4096;
+        constexpr size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+        size_t mapped_size(size_t bytes, page_options options) {
+            size_t page = options.huge_pages ? HUGE_PAGE_BYTES : PAGE_BYTES;
+            return (bytes + page - 1) / page * page;
+        }
+    } // namespace
+
+    void *map(size_t bytes, page_options options) {
+        size_t size = mapped_size(bytes, options);
+
+        if (options.huge_pages) {
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (options.prefault ? MAP_POPULATE : 0);
+            void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (memory != MAP_FAILED) {
+                return memory;
+            }
+        }
+
+        void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        // No hugetlbfs pool: fall back to transparent huge pages, asked for before populating so that the range is
+        // faulted in as huge pages rather than collapsed later.
+        if (options.huge_pages) {
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+        if (options.prefault) {
+            madvise(memory, size, MADV_POPULATE_WRITE);
+        }
+        return memory;
+    }
+
+    void unmap(void *memory, size_t bytes, page_options options) { munmap(memory, mapped_size(bytes, options)); }
+
+} // namespace page_memory
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// How memory that is set aside up front should be backed.
+struct page_options {
+    bool mapped = false;     // straight from mmap rather than the heap
+    bool huge_pages = false; // 2 MiB pages: hugetlbfs if the node has a pool reserved, transparent huge pages if not
+    bool prefault = false;   // populate the pages now, so the first touch does not fault
+
+    friend bool operator==(const page_options &, const page_options &) = default;
+};
+
+namespace page_memory {
+    // Both throw std::bad_alloc when the mapping fails; `bytes` must match between the two calls.
+    [[nodiscard]] void *map(size_t bytes, page_options options);
+    void unmap(void *memory, size_t bytes, page_options options);
+} // namespace page_memory
+
+// Hands out memory from page_memory when given mapped options and from the heap otherwise, so a container can take
+// its storage on huge, prefaulted pages without changing type. The options travel with the container on move.
+template<typename T>
+class page_allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    page_allocator() = default;
+    explicit page_allocator(page_options options) : _options(options) {}
+
+    template<typename U>
+    page_allocator(const page_allocator<U> &other) : _options(other.options()) {}
+
+    [[nodiscard]] T *allocate(size_t n) {
+        if (not _options.mapped) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        return static_cast<T *>(page_memory::map(n * sizeof(T), _options));
+    }
+
+    void deallocate(T *memory, size_t n) {
+        if (not _options.mapped) {
+            std::allocator<T>{}.deallocate(memory, n);
+            return;
+        }
+        page_memory::unmap(memory, n * sizeof(T), _options);
+    }
+
+    [[nodiscard]] page_options options() const { return _options; }
+
+    friend bool operator==(const page_allocator &a, const page_allocator &b) { return a._options == b._options; }
+
+private:
+    page_options _options;
+};
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include <response_cache.hpp>
+
+response_cache::response_cache(size_t capacity, std::chrono::milliseconds ttl) : _ttl(ttl) {
+    if (capacity == 0) {
+        throw std::invalid_argument("response_cache: capacity must be positive");
+    }
+
+    _entries.resize(std::bit_ceil(std::max(capacity, PROBE_LIMIT)));
+    _mask = _entries.size() - 1;
+}
+
+std::optional<packet_result> response_cache::find(const sockaddr_in &client_addr, std::span<const uint8_t> request,
+                                                  clock::time_point now) const {
+    if (request.size() > MAX_REQUEST_SIZE) {
+        return std::nullopt;
+    }
+
+    uint64_t key = hash(client_addr, request);
+    for (size_t i = 0; i < PROBE_LIMIT; ++i) {
+        const entry &candidate = _entries[(key + i) & _mask];
+        if (candidate.expires_at > now && matches(candidate, key, client_addr, request)) {
+            return candidate.result;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void response_cache::insert(const sockaddr_in &client_addr, std::span<const uint8_t> request, packet_result result,
+                            clock::time_point now) {
+    if (request.size() > MAX_REQUEST_SIZE) {
+        return;
+    }
+
+    uint64_t key = hash(client_addr, request);
+
+    // Refresh the same request in place; otherwise take the oldest slot in the probe window, which is an
+    // expired or empty one whenever there is any.
+    entry *victim = nullptr;
+    for (size_t i = 0; i < PROBE_LIMIT; ++i) {
+        entry &candidate = _entries[(key + i) & _mask];
+        if (matches(candidate, key, client_addr, request)) {
+            victim = &candidate;
+            break;
+        }
+        if (victim == nullptr || candidate.expires_at < victim->expires_at) {
+            victim = &candidate;
+        }
+    }
+
+    victim->expires_at = now + _ttl;
+    victim->hash = key;
+    victim->addr = client_addr.sin_addr.s_addr;
+    victim->port = client_addr.sin_port;
+    victim->size = static_cast<uint8_t>(request.size());
+    victim->result = result;
+    std::memcpy(victim->request.data(), request.data(), request.size());
+}
+
+uint64_t response_cache::hash(const sockaddr_in &client_addr, std::span<const uint8_t> request) {
+    constexpr uint64_t fnv_offset = 14695981039346656037ull;
+    constexpr uint64_t fnv_prime = 1099511628211ull;
+
+    uint64_t hash = fnv_offset;
+    auto mix = [&hash](uint8_t byte) { hash = (hash ^ byte) * fnv_prime; };
+
+    for (size_t i = 0; i < sizeof(client_addr.sin_addr.s_addr); ++i) {
+        mix(static_cast<uint8_t>(client_addr.sin_addr.s_addr >> (i * 8)));
+    }
+    mix(static_cast<uint8_t>(client_addr.sin_port));
+    mix(static_cast<uint8_t>(client_addr.sin_port >> 8));
+    for (uint8_t byte: request) {
+        mix(byte);
+    }
+
+    return hash ^ (hash >> 32);
+}
+
+bool response_cache::matches(const entry &entry, uint64_t hash, const sockaddr_in &client_addr,
+                             std::span<const uint8_t> request) {
+    return entry.hash == hash && entry.addr == client_addr.sin_addr.s_addr && entry.port == client_addr.sin_port &&
+           entry.size == request.size() && std::memcmp(entry.request.data(), request.data(), request.size()) == 0;
+}
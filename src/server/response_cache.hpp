@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <packet_manager.hpp>
+#include <utility.hpp>
+
+// Remembers the reply to recent requests so a retransmitted datagram (same client address, same bytes)
+// gets the original answer replayed instead of hitting the session table a second time.
+class response_cache {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_REQUEST_SIZE = utility::MAX_IMSI_PACKET_SIZE;
+    static constexpr size_t PROBE_LIMIT = 8;
+
+    response_cache(size_t capacity, std::chrono::milliseconds ttl);
+
+    response_cache(const response_cache &) = delete;
+    response_cache &operator=(const response_cache &) = delete;
+
+    [[nodiscard]] std::optional<packet_result> find(const sockaddr_in &client_addr, std::span<const uint8_t> request,
+                                                    clock::time_point now) const;
+    void insert(const sockaddr_in &client_addr, std::span<const uint8_t> request, packet_result result,
+                clock::time_point now);
+
+    [[nodiscard]] size_t capacity() const { return _entries.size(); }
+
+private:
+    struct entry {
+        clock::time_point expires_at;
+        uint64_t hash;
+        uint32_t addr;
+        uint16_t port;
+        uint8_t size;
+        packet_result result;
+        std::array<uint8_t, MAX_REQUEST_SIZE> request;
+    };
+
+    [[nodiscard]] static uint64_t hash(const sockaddr_in &client_addr, std::span<const uint8_t> request);
+    [[nodiscard]] static bool matches(const entry &entry, uint64_t hash, const sockaddr_in &client_addr,
+                                      std::span<const uint8_t> request);
+
+private:
+    std::chrono::milliseconds _ttl;
+    size_t _mask;
+
+    std::vector<entry> _entries;
+};
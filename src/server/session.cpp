@@ -1,9 +1,9 @@
 #include <session.hpp>
 
-std::shared_ptr<session> session::create(std::string imsi) {
-    return std::shared_ptr<session>(new session(std::move(imsi)));
-}
+session::session(packed_imsi imsi) : _imsi(imsi) {}
 
-std::string session::get_imsi() const { return _imsi; }
+packed_imsi session::get_imsi() const { return _imsi; }
 
-session::session(std::string imsi) : _imsi(std::move(imsi)) {}
+uint64_t session::get_expiry_timer() const { return _expiry_timer; }
+
+void session::set_expiry_timer(uint64_t timer) { _expiry_timer = timer; }
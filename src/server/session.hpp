@@ -1,16 +1,20 @@
 #pragma once
 
-#include <memory>
-#include <string>
+#include <cstdint>
+
+#include <packed_imsi.hpp>
 
 class session {
 public:
-    static std::shared_ptr<session> create(std::string imsi);
+    session() = default;
+    explicit session(packed_imsi imsi);
 
-    std::string get_imsi() const;
+    [[nodiscard]] packed_imsi get_imsi() const;
 
-private:
-    session(std::string imsi);
+    [[nodiscard]] uint64_t get_expiry_timer() const;
+    void set_expiry_timer(uint64_t timer);
 
-    std::string _imsi;
+private:
+    packed_imsi _imsi;
+    uint64_t _expiry_timer = 0;
 };
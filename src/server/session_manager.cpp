@@ -1,88 +1,487 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
 #include <session_manager.hpp>
 
+#include <blacklist_file.hpp>
 #include <config.hpp>
 #include <event_bus.hpp>
 #include <logger.hpp>
 #include <session.hpp>
+#include <token_bucket.hpp>
 
 session_manager::session_manager(std::shared_ptr<config> config, std::shared_ptr<event_bus> event_bus,
                                  std::shared_ptr<logger> logger) :
     _config(std::move(config)), _event_bus(std::move(event_bus)), _logger(std::move(logger)),
-    _blacklist(_config->get_blacklist().value()) {
+    _blacklist(std::make_unique<const blacklist>()), _expiry_timer_fd(-1) {
+
+    load_blacklist();
+
+    auto timeout = std::chrono::seconds(_config->get_session_timeout_sec().value());
+    _session_timeout_ticks = timeout / EXPIRY_TICK;
 
-    _logger->info("Session manager initialized with " + std::to_string(_blacklist.size()) + " blacklisted IMSIs");
+    preallocate_sessions();
+    open_session_store();
+
+    _logger->info("Session manager initialized with " + std::to_string(blacklist_size()) + " blacklisted IMSIs");
     setup_event_handlers();
+    setup_expiry_timer();
+}
+
+session_manager::~session_manager() {
+    if (_expiry_thread.joinable()) {
+        _expiry_thread.request_stop();
+        _expiry_thread.join();
+    }
+
+    if (_expiry_timer_fd >= 0) {
+        close(_expiry_timer_fd);
+    }
+
+    _logger->info("Session manager is destroyed");
+}
+
+void session_manager::load_blacklist() {
+    std::vector<packed_imsi> imsis;
+
+    if (const auto &entries = _config->get_blacklist(); entries.has_value()) {
+        imsis.reserve(entries->size());
+
+        for (const auto &entry: *entries) {
+            auto imsi = packed_imsi::from_string(entry);
+            if (not imsi.has_value()) {
+                _logger->warning("Ignoring invalid blacklisted IMSI: " + entry);
+                continue;
+            }
+            imsis.push_back(imsi.value());
+        }
+    }
+
+    if (auto path = _config->get_blacklist_file(); path.has_value()) {
+        auto started_at = std::chrono::steady_clock::now();
+        auto contents = read_blacklist_file(path.value(), std::max(1u, std::thread::hardware_concurrency()));
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                             started_at);
+
+        _logger->info("Read " + std::to_string(contents.imsis.size()) + " IMSIs from blacklist file " +
+                      path->string() + " in " + std::to_string(elapsed.count()) + " ms");
+        if (contents.invalid_lines != 0) {
+            _logger->warning("Ignored " + std::to_string(contents.invalid_lines) + " invalid lines in blacklist file " +
+                             path->string());
+        }
+
+        // The file's IMSIs arrive sorted; merging the few from the config into them keeps the whole list sorted, so
+        // building the blacklist skips the sort.
+        merge_blacklists(imsis, std::move(contents.imsis));
+    }
+
+    publish_blacklist(std::move(imsis));
+}
+
+void session_manager::publish_blacklist(std::vector<packed_imsi> imsis) {
+    auto started_at = std::chrono::steady_clock::now();
+    auto next = std::make_unique<const blacklist>(std::move(imsis));
+    auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_at);
+
+    _logger->info("Blacklist holds " + std::to_string(next->size()) + " IMSIs in " +
+                  std::to_string(next->memory_usage()) + " bytes (Bloom filter " +
+                  std::to_string(next->filter_memory_usage()) + " bytes), built in " +
+                  std::to_string(elapsed.count()) + " ms");
+
+    _blacklist.publish(std::move(next));
+}
+
+void session_manager::preallocate_sessions() {
+    auto max_sessions = _config->get_max_sessions();
+    if (not max_sessions.has_value() || max_sessions.value() == 0) {
+        return;
+    }
+
+    // Shard sizes spread around the mean by about its square root; four of those on top keep a shard from filling
+    // up before the whole table does in all but freak cases.
+    _max_sessions = max_sessions.value();
+    size_t share = (_max_sessions + SHARDS - 1) / SHARDS;
+    _shard_capacity = share + 4 * static_cast<size_t>(std::sqrt(static_cast<double>(share))) + 16;
+
+    page_options options{.mapped = true,
+                         .huge_pages = _config->get_session_huge_pages().value_or(false),
+                         .prefault = _config->get_session_prefault().value_or(true)};
+
+    auto started_at = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (auto &shard: _shards) {
+        shard.sessions.preallocate(_shard_capacity, options);
+        shard.expiries.preallocate(_shard_capacity, options);
+        bytes += shard.sessions.memory_usage();
+    }
+    auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_at);
+
+    _logger->info("Preallocated storage for " + std::to_string(_max_sessions) + " sessions (" +
+                  std::to_string(_shard_capacity) + " per shard, " + std::to_string(bytes) + " bytes of tables" +
+                  (options.huge_pages ? ", huge pages" : "") + (options.prefault ? ", prefaulted" : "") + ") in " +
+                  std::to_string(elapsed.count()) + " ms");
+}
+
+void session_manager::open_session_store() {
+    auto path = _config->get_session_state_file();
+    if (not path.has_value()) {
+        return;
+    }
+
+    _store = std::make_unique<session_store>(path.value());
+    for (auto &shard: _shards) {
+        shard.records.attach(*_store);
+    }
+
+    _logger->info("Persisting sessions to " + path->string());
+    restore_sessions();
+
+    // Restored sessions went into the file's existing extents; with a limit the rest are taken now, so that no
+    // creation has to grow the file.
+    if (_shard_capacity != 0) {
+        for (auto &shard: _shards) {
+            shard.records.reserve(static_cast<uint32_t>(_shard_capacity));
+        }
+    }
+}
+
+void session_manager::restore_sessions() {
+    auto started_at = std::chrono::steady_clock::now();
+
+    int64_t now_ms = unix_time_ms();
+    size_t expired = 0;
+    size_t blacklisted = 0;
+
+    // Sessions spread evenly over the shards, so sizing each list for its share (with some slack) saves regrowing
+    // and copying them while the file is read.
+    std::array<std::vector<session_record>, SHARDS> by_shard;
+    for (auto &records: by_shard) {
+        records.reserve(_store->restorable_records() / SHARDS * 9 / 8 + 64);
+    }
+    {
+        auto current = _blacklist.read();
+        _store->restore([&](const session_record &record) {
+            auto imsi = packed_imsi::from_packed(record.imsi);
+            if (record.expires_at_ms <= now_ms) {
+                ++expired;
+            } else if (current->contains(imsi)) {
+                ++blacklisted;
+            } else {
+                by_shard[shard_index(imsi)].push_back(record);
+            }
+        });
+    }
+
+    // Over the limit (it may have been lowered since) the surplus is dropped, as if refused at creation.
+    size_t over_capacity = 0;
+    if (_max_sessions != 0) {
+        size_t budget = _max_sessions;
+        for (auto &records: by_shard) {
+            size_t kept = std::min({records.size(), _shard_capacity, budget});
+            over_capacity += records.size() - kept;
+            records.resize(kept);
+            budget -= kept;
+        }
+    }
+
+    // Shards share nothing, so they are rebuilt in parallel.
+    size_t workers_num = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, SHARDS);
+    {
+        std::vector<std::jthread> workers;
+        for (size_t w = 0; w < workers_num; ++w) {
+            workers.emplace_back([&, w]() {
+                for (size_t i = w; i < SHARDS; i += workers_num) {
+                    restore_shard(_shards[i], by_shard[i], now_ms);
+                }
+            });
+        }
+    }
+
+    size_t restored = 0;
+    for (const auto &shard: _shards) {
+        restored += shard.sessions.size();
+    }
+    _session_count.fetch_add(restored, std::memory_order_relaxed);
+
+    auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_at);
+    _logger->info("Restored " + std::to_string(restored) + " sessions in " + std::to_string(elapsed.count()) +
+                  " ms (" + std::to_string(expired) + " expired while down, " + std::to_string(blacklisted) +
+                  " now blacklisted, " + std::to_string(over_capacity) + " over capacity)");
 }
 
-session_manager::~session_manager() { _logger->info("Session manager is destroyed"); }
+void session_manager::restore_shard(shard &shard, std::span<const session_record> records, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    shard.sessions.reserve(records.size());
+    shard.expiries.reserve(records.size());
+
+    auto tick_ms = std::chrono::duration_cast<std::chrono::milliseconds>(EXPIRY_TICK).count();
+    for (size_t i = 0; i < records.size(); ++i) {
+        // Index entries land at random; asking for one a few records ahead hides most of the cache misses.
+        if (i + RESTORE_PREFETCH_DISTANCE < records.size()) {
+            shard.sessions.prefetch(packed_imsi::from_packed(records[i + RESTORE_PREFETCH_DISTANCE].imsi));
+        }
+
+        const session_record &record = records[i];
+        session_handle handle = shard.sessions.insert(packed_imsi::from_packed(record.imsi));
+        if (not handle.valid()) {
+            continue;
+        }
+
+        // The remaining lifetime rounds up to whole ticks, so a session never expires early.
+        auto ticks = static_cast<uint64_t>((record.expires_at_ms - now_ms + tick_ms - 1) / tick_ms);
+        shard.sessions.get(handle)->set_expiry_timer(shard.expiries.schedule(ticks, handle));
+        shard.records.write(handle.slot, record);
+    }
+}
 
 void session_manager::setup_event_handlers() {
     _logger->info("Setting up session manager event handlers");
 
-    _event_bus->subscribe<events::create_session_event>([this](std::string imsi) {
-        _logger->debug("Scheduling session deletion for IMSI: " + imsi);
+    // The drain is paced and may run for long, so it goes to the pool rather than holding up the publisher.
+    _event_bus->subscribe<events::graceful_shutdown_event>([this]() { graceful_shutdown_worker(); },
+                                                          {.name = "session_manager"});
 
-        std::chrono::seconds timeout = std::chrono::seconds(_config->get_session_timeout_sec().value());
+    _logger->info("Session manager setup of event handlers is completed");
+}
 
-        _logger->debug("Session for IMSI " + imsi + " will expire in " + std::to_string(timeout.count()) + " seconds");
+void session_manager::setup_expiry_timer() {
+    _expiry_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (_expiry_timer_fd < 0) {
+        _logger->fatal("Failed to create expiry timer: " + std::string(strerror(errno)));
+        throw session_manager_exception("Failed to create expiry timer");
+    }
 
-        std::this_thread::sleep_for(timeout);
+    auto tick_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(EXPIRY_TICK).count();
+    itimerspec spec{};
+    spec.it_interval.tv_sec = tick_ns / 1'000'000'000;
+    spec.it_interval.tv_nsec = tick_ns % 1'000'000'000;
+    spec.it_value = spec.it_interval;
 
-        delete_session(imsi);
-        _logger->info("Session expired for IMSI: " + imsi);
+    if (timerfd_settime(_expiry_timer_fd, 0, &spec, nullptr) < 0) {
+        _logger->fatal("Failed to arm expiry timer: " + std::string(strerror(errno)));
+        throw session_manager_exception("Failed to arm expiry timer");
+    }
 
-        _event_bus->publish<events::delete_session_event>(imsi);
-    });
+    _expiry_thread = std::jthread([this](std::stop_token st) { expiry_worker(st); });
 
-    _event_bus->subscribe<events::graceful_shutdown_event>([this]() { graceful_shutdown_worker(); });
+    _logger->info("Session expiry timer started with " + std::to_string(EXPIRY_TICK.count()) + " ms tick (" +
+                  std::to_string(_session_timeout_ticks) + " ticks per session)");
+}
 
-    _logger->info("Session manager setup of event handlers is completed");
+void session_manager::expiry_worker(std::stop_token st) {
+    while (not st.stop_requested()) {
+        uint64_t expirations = 0;
+        ssize_t n = read(_expiry_timer_fd, &expirations, sizeof(expirations));
+
+        if (n != static_cast<ssize_t>(sizeof(expirations))) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            _logger->error("Failed to read expiry timer: " + std::string(strerror(errno)));
+            return;
+        }
+
+        // A late wakeup reports several expirations; the wheel catches up on all of them in one pass.
+        expire_sessions(expirations);
+    }
+}
+
+void session_manager::expire_sessions(uint64_t ticks) {
+    std::vector<packed_imsi> expired;
+
+    for (auto &shard: _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.expiries.advance(ticks, [&](expiry_wheel::timer_id, session_handle handle) {
+            const session *expiring = shard.sessions.get(handle);
+            if (expiring == nullptr) {
+                return;
+            }
+
+            expired.push_back(expiring->get_imsi());
+            shard.records.clear(handle.slot);
+            shard.sessions.erase(handle);
+        });
+    }
+
+    if (expired.empty()) {
+        return;
+    }
+    _session_count.fetch_sub(expired.size(), std::memory_order_relaxed);
+
+    _logger->debug("Expired " + std::to_string(expired.size()) + " sessions");
+
+    for (auto imsi: expired) {
+        _logger->info("Session expired for IMSI: " + imsi.to_string());
+    }
+    // One event per tick, so the CDR writer records the whole tick's expiries in one write.
+    _event_bus->publish<events::delete_sessions_event>(std::move(expired));
+}
+
+size_t session_manager::shard_index(packed_imsi imsi) {
+    // The shard comes from the top bits of the hash, the shard's own buckets from the low ones.
+    uint64_t hash = std::hash<packed_imsi>{}(imsi);
+    return hash >> (64 - SHARD_BITS);
+}
+
+int64_t session_manager::unix_time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
 }
 
-std::shared_ptr<session> session_manager::create_session(const std::string &imsi) {
-    std::lock_guard<std::mutex> lock(_sessions_mutex);
+create_session_result session_manager::create_session(packed_imsi imsi) {
+    shard &shard = _shards[shard_index(imsi)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    if (_sessions.contains(imsi)) {
-        _logger->debug("Session creation failed - IMSI already exists: " + imsi);
-        return nullptr;
+    // An existing session is reported as such even when the table is full.
+    if (shard.sessions.contains(imsi)) {
+        if (_logger->is_enabled(logger::log_level::debug)) {
+            _logger->debug("Session creation failed - IMSI already exists: " + imsi.to_string());
+        }
+        return create_session_result::already_exists;
+    }
+
+    if (not claim_capacity(shard)) {
+        if (_logger->is_enabled(logger::log_level::debug)) {
+            _logger->debug("Session creation failed - capacity of " + std::to_string(_max_sessions) +
+                           " sessions exceeded: " + imsi.to_string());
+        }
+        return create_session_result::capacity_exceeded;
+    }
+
+    session_handle handle = shard.sessions.insert(imsi);
+
+    shard.sessions.get(handle)->set_expiry_timer(shard.expiries.schedule(_session_timeout_ticks, handle));
+
+    if (_store != nullptr) {
+        int64_t now_ms = unix_time_ms();
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(_session_timeout_ticks * EXPIRY_TICK);
+        shard.records.write(handle.slot, {.imsi = imsi.packed(),
+                                          .created_at_ms = now_ms,
+                                          .expires_at_ms = now_ms + timeout.count()});
     }
 
-    _sessions[imsi] = session::create(imsi);
-    _logger->debug("Session created successfully for IMSI: " + imsi +
-                   " (total sessions: " + std::to_string(_sessions.size()) + ")");
+    if (_logger->is_enabled(logger::log_level::debug)) {
+        _logger->debug("Session created successfully for IMSI: " + imsi.to_string() +
+                       " (sessions in shard: " + std::to_string(shard.sessions.size()) + ")");
+    }
 
-    return _sessions[imsi];
+    return create_session_result::created;
 }
 
-void session_manager::delete_session(const std::string &imsi) {
-    std::lock_guard<std::mutex> lock(_sessions_mutex);
+bool session_manager::claim_capacity(const shard &shard) {
+    // Counted before checking, so that creations racing in other shards cannot overshoot the limit together.
+    size_t before = _session_count.fetch_add(1, std::memory_order_relaxed);
+    if (_max_sessions == 0 || (before < _max_sessions && shard.sessions.size() < _shard_capacity)) {
+        return true;
+    }
 
-    auto it = _sessions.find(imsi);
-    if (it != _sessions.end()) {
-        _sessions.erase(it);
-        _logger->debug("Session deleted for IMSI: " + imsi +
-                       " (remaining sessions: " + std::to_string(_sessions.size()) + ")");
+    _session_count.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
+
+void session_manager::delete_session(packed_imsi imsi) {
+    shard &shard = _shards[shard_index(imsi)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (erase_session(shard, imsi)) {
+        if (_logger->is_enabled(logger::log_level::debug)) {
+            _logger->debug("Session deleted for IMSI: " + imsi.to_string() +
+                           " (remaining in shard: " + std::to_string(shard.sessions.size()) + ")");
+        }
     } else {
-        _logger->warning("Attempted to delete non-existent session for IMSI: " + imsi);
+        _logger->warning("Attempted to delete non-existent session for IMSI: " + imsi.to_string());
     }
 }
 
-bool session_manager::has_blacklist_session(const std::string &imsi) const {
-    std::lock_guard<std::mutex> lock(_sessions_mutex);
+bool session_manager::erase_session(shard &shard, packed_imsi imsi) {
+    session_handle handle = shard.sessions.find(imsi);
+    if (not handle.valid()) {
+        return false;
+    }
 
-    bool is_blacklisted = _blacklist.contains(imsi);
-    if (is_blacklisted) {
-        _logger->debug("IMSI " + imsi + " found in blacklist");
+    shard.expiries.cancel(shard.sessions.get(handle)->get_expiry_timer());
+    shard.records.clear(handle.slot);
+    shard.sessions.erase(handle);
+    _session_count.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool session_manager::has_blacklist_session(packed_imsi imsi) const {
+    // Pins the current snapshot without a lock; an update published meanwhile waits for this lookup to finish.
+    bool is_blacklisted = _blacklist.read()->contains(imsi);
+    if (is_blacklisted && _logger->is_enabled(logger::log_level::debug)) {
+        _logger->debug("IMSI " + imsi.to_string() + " found in blacklist");
     }
     return is_blacklisted;
 }
 
-bool session_manager::has_active_session(const std::string &imsi) const {
-    std::lock_guard<std::mutex> lock(_sessions_mutex);
+size_t session_manager::add_to_blacklist(std::vector<packed_imsi> imsis) {
+    std::sort(imsis.begin(), imsis.end());
+    imsis.erase(std::unique(imsis.begin(), imsis.end()), imsis.end());
+
+    std::lock_guard<std::mutex> lock(_blacklist_update_mutex);
+
+    std::vector<packed_imsi> current = _blacklist.read()->entries();
+    std::vector<packed_imsi> updated;
+    updated.reserve(current.size() + imsis.size());
+    std::set_union(current.begin(), current.end(), imsis.begin(), imsis.end(), std::back_inserter(updated));
+
+    size_t added = updated.size() - current.size();
+    if (added != 0) {
+        publish_blacklist(std::move(updated));
+    }
+
+    _logger->info("Added " + std::to_string(added) + " IMSIs to blacklist");
+    return added;
+}
+
+size_t session_manager::remove_from_blacklist(std::vector<packed_imsi> imsis) {
+    std::sort(imsis.begin(), imsis.end());
+    imsis.erase(std::unique(imsis.begin(), imsis.end()), imsis.end());
 
-    bool is_active = _sessions.contains(imsi);
-    if (is_active) {
-        _logger->debug("IMSI " + imsi + " is active");
+    std::lock_guard<std::mutex> lock(_blacklist_update_mutex);
+
+    std::vector<packed_imsi> current = _blacklist.read()->entries();
+    std::vector<packed_imsi> updated;
+    updated.reserve(current.size());
+    std::set_difference(current.begin(), current.end(), imsis.begin(), imsis.end(), std::back_inserter(updated));
+
+    size_t removed = current.size() - updated.size();
+    if (removed != 0) {
+        publish_blacklist(std::move(updated));
+    }
+
+    _logger->info("Removed " + std::to_string(removed) + " IMSIs from blacklist");
+    return removed;
+}
+
+void session_manager::replace_blacklist(std::vector<packed_imsi> imsis) {
+    std::lock_guard<std::mutex> lock(_blacklist_update_mutex);
+
+    publish_blacklist(std::move(imsis));
+    _logger->info("Replaced blacklist");
+}
+
+size_t session_manager::blacklist_size() const { return _blacklist.read()->size(); }
+
+bool session_manager::has_active_session(packed_imsi imsi) const {
+    // Status checks skip the shard lock so that polling never stalls attaches on the same shard.
+    bool is_active = _shards[shard_index(imsi)].sessions.concurrent_contains(imsi);
+    if (is_active && _logger->is_enabled(logger::log_level::debug)) {
+        _logger->debug("IMSI " + imsi.to_string() + " is active");
     }
     return is_active;
 }
@@ -95,31 +494,114 @@ void session_manager::graceful_shutdown_worker() {
 
     _logger->info("Starting graceful shutdown worker");
 
-    auto shutdown_rate = _config->get_graceful_shutdown_rate().value();
-    auto delay_ms = std::chrono::milliseconds(1000 / shutdown_rate);
+    uint32_t shutdown_rate = std::max(1u, _config->get_graceful_shutdown_rate().value());
+    auto started_at = std::chrono::steady_clock::now();
+
+    _drain_rate.store(shutdown_rate);
+    _drain_started_at.store(started_at.time_since_epoch().count());
+    _drain_state.store(drain_progress::state::draining);
 
     _logger->info("Graceful shutdown rate: " + std::to_string(shutdown_rate) + " sessions per second");
 
-    while (true) {
-        std::string imsi_to_delete;
+    // Sessions go in batches every DRAIN_TICK, as many as the bucket has earned since the last one, so any rate is
+    // reachable and the pace holds even when a tick runs late. Up to two ticks' worth may pile up.
+    auto ticks_per_second = static_cast<uint64_t>(std::chrono::milliseconds(std::chrono::seconds(1)) / DRAIN_TICK);
+    token_bucket pacer(shutdown_rate, 2 * shutdown_rate / ticks_per_second, started_at);
+
+    std::vector<packed_imsi> released;
+    auto next_tick = started_at;
+
+    // Sessions that slipped in after a snapshot are picked up by the next one.
+    for (auto pending = snapshot_sessions(); not pending.empty(); pending = snapshot_sessions()) {
+        _drain_total.fetch_add(pending.size());
+
+        std::span<const packed_imsi> rest(pending);
+        while (not rest.empty()) {
+            next_tick += DRAIN_TICK;
+            std::this_thread::sleep_until(next_tick);
 
-        {
-            std::lock_guard<std::mutex> lock(_sessions_mutex);
-            if (_sessions.empty()) {
-                _logger->info("All sessions have been gracefully removed");
-                break;
+            size_t batch = std::min(pacer.take(std::chrono::steady_clock::now()), rest.size());
+            if (batch == 0) {
+                continue;
             }
 
-            imsi_to_delete = _sessions.begin()->first;
+            release_sessions(rest.first(batch), released);
+            rest = rest.subspan(batch);
+
+            // Only sessions actually removed count as released; those that expired or were deleted since the
+            // snapshot leave the total instead, so remaining still reaches zero.
+            _drain_released.fetch_add(released.size());
+            _drain_total.fetch_sub(batch - released.size());
+
+            if (not released.empty()) {
+                _logger->info("Gracefully removed " + std::to_string(released.size()) + " sessions (" +
+                              std::to_string(_drain_released.load()) + " of " + std::to_string(_drain_total.load()) +
+                              ")");
+                _event_bus->publish<events::delete_sessions_event>(std::move(released));
+                released.clear();
+            }
         }
+    }
 
-        delete_session(imsi_to_delete);
-        _logger->info("Gracefully removed session for IMSI: " + imsi_to_delete);
+    _drain_finished_at.store(std::chrono::steady_clock::now().time_since_epoch().count());
+    _drain_state.store(drain_progress::state::completed);
 
-        _event_bus->publish<events::delete_session_event>(imsi_to_delete);
+    auto progress = get_drain_progress();
+    _logger->info("Graceful shutdown completed - all sessions removed (" + std::to_string(progress.released) +
+                  " sessions at " + std::to_string(static_cast<uint64_t>(progress.achieved_rate)) + " per second)");
+}
 
-        std::this_thread::sleep_for(delay_ms);
+std::vector<packed_imsi> session_manager::snapshot_sessions() const {
+    // Shard by shard, so consecutive IMSIs share a shard and release_sessions() locks each one once per batch.
+    std::vector<packed_imsi> imsis;
+    for (const auto &shard: _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto &entry: shard.sessions.sessions()) {
+            imsis.push_back(entry.get_imsi());
+        }
     }
+    return imsis;
+}
+
+void session_manager::release_sessions(std::span<const packed_imsi> imsis, std::vector<packed_imsi> &released) {
+    std::unique_lock<std::mutex> lock;
+    shard *locked = nullptr;
+
+    for (auto imsi: imsis) {
+        shard &owner = _shards[shard_index(imsi)];
+        if (&owner != locked) {
+            lock = std::unique_lock<std::mutex>(owner.mutex);
+            locked = &owner;
+        }
 
-    _logger->info("Graceful shutdown completed - all sessions removed");
+        // Expired or deleted since the snapshot: nothing to release and no CDR to write.
+        if (erase_session(owner, imsi)) {
+            released.push_back(imsi);
+        }
+    }
+}
+
+drain_progress session_manager::get_drain_progress() const {
+    drain_progress progress;
+    progress.status = _drain_state.load();
+    if (progress.status == drain_progress::state::idle) {
+        return progress;
+    }
+
+    progress.total = _drain_total.load();
+    progress.released = _drain_released.load();
+    progress.target_rate = _drain_rate.load();
+
+    auto finished_at = progress.status == drain_progress::state::completed
+                               ? std::chrono::steady_clock::time_point(
+                                         std::chrono::steady_clock::duration(_drain_finished_at.load()))
+                               : std::chrono::steady_clock::now();
+    auto started_at =
+            std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(_drain_started_at.load()));
+
+    std::chrono::duration<double> elapsed = finished_at - started_at;
+    if (elapsed.count() > 0.0) {
+        progress.achieved_rate = static_cast<double>(progress.released) / elapsed.count();
+    }
+    return progress;
 }
@@ -1,43 +1,143 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <mutex>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
-#include <unordered_map>
-#include <unordered_set>
+#include <thread>
+#include <vector>
+
+#include <blacklist.hpp>
+#include <packed_imsi.hpp>
+#include <session_store.hpp>
+#include <session_table.hpp>
+#include <snapshot_ptr.hpp>
+#include <timer_wheel.hpp>
 
-class session;
 class event_bus;
 class config;
 class logger;
 
+class session_manager_exception : public std::runtime_error {
+public:
+    explicit session_manager_exception(const std::string &message) :
+        std::runtime_error("session_manager_exception: " + message) {}
+};
+
+enum class create_session_result { created, already_exists, capacity_exceeded };
+
+// Where a graceful drain stands; `total` grows if sessions created after the drain began are swept up as well.
+struct drain_progress {
+    enum class state { idle, draining, completed };
+
+    state status = state::idle;
+    size_t total = 0;
+    size_t released = 0;
+    uint32_t target_rate = 0;
+    double achieved_rate = 0.0; // sessions per second since the drain began
+};
+
 class session_manager {
 public:
     session_manager(std::shared_ptr<config> config, std::shared_ptr<event_bus> event_bus,
                     std::shared_ptr<logger> logger);
     ~session_manager();
 
+    session_manager(const session_manager &) = delete;
+    session_manager &operator=(const session_manager &) = delete;
+    session_manager(session_manager &&) = delete;
+    session_manager &operator=(session_manager &&) = delete;
+
 public:
-    [[nodiscard]] std::shared_ptr<session> create_session(const std::string &imsi);
-    void delete_session(const std::string &imsi);
+    [[nodiscard]] create_session_result create_session(packed_imsi imsi);
+    void delete_session(packed_imsi imsi);
+
+    [[nodiscard]] bool has_blacklist_session(packed_imsi imsi) const;
+    [[nodiscard]] bool has_active_session(packed_imsi imsi) const;
 
-    [[nodiscard]] bool has_blacklist_session(const std::string &imsi) const;
-    [[nodiscard]] bool has_active_session(const std::string &imsi) const;
+    // Each change builds a new blacklist and swaps it in; lookups in flight finish on the one they started with.
+    // Return how many entries were actually added or removed.
+    size_t add_to_blacklist(std::vector<packed_imsi> imsis);
+    size_t remove_from_blacklist(std::vector<packed_imsi> imsis);
+    void replace_blacklist(std::vector<packed_imsi> imsis);
+    [[nodiscard]] size_t blacklist_size() const;
+
+    [[nodiscard]] drain_progress get_drain_progress() const;
+
+private:
+    static constexpr std::chrono::milliseconds EXPIRY_TICK{100};
+    static constexpr std::chrono::milliseconds DRAIN_TICK{10};
+    static constexpr uint32_t SHARD_BITS = 6;
+    static constexpr uint32_t SHARDS = 1u << SHARD_BITS;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t RESTORE_PREFETCH_DISTANCE = 8;
+
+    using expiry_wheel = timer_wheel<session_handle>;
+
+    // Sessions are split by IMSI hash so that different subscribers rarely share a lock; each shard expires its
+    // own sessions, so neither lookups nor the timer thread take a table-wide lock. With a session state file the
+    // shard also mirrors its sessions into its own region of it, indexed by session slot.
+    struct alignas(CACHE_LINE_SIZE) shard {
+        mutable std::mutex mutex;
+        session_table sessions;
+        expiry_wheel expiries;
+        session_store::region records;
+    };
 
 private:
+    void load_blacklist();
+    void preallocate_sessions();
+    void open_session_store();
+    void restore_sessions();
+    void restore_shard(shard &shard, std::span<const session_record> records, int64_t now_ms);
+    void publish_blacklist(std::vector<packed_imsi> imsis);
     void setup_event_handlers();
+    void setup_expiry_timer();
+    void expiry_worker(std::stop_token st);
+    void expire_sessions(uint64_t ticks);
     void graceful_shutdown_worker();
+    [[nodiscard]] std::vector<packed_imsi> snapshot_sessions() const;
+    void release_sessions(std::span<const packed_imsi> imsis, std::vector<packed_imsi> &released);
+    bool erase_session(shard &shard, packed_imsi imsi);
+    [[nodiscard]] bool claim_capacity(const shard &shard);
+
+    [[nodiscard]] static size_t shard_index(packed_imsi imsi);
+    [[nodiscard]] static int64_t unix_time_ms();
 
 private:
     std::shared_ptr<config> _config;
     std::shared_ptr<event_bus> _event_bus;
     std::shared_ptr<logger> _logger;
 
-    std::unordered_map<std::string, std::shared_ptr<session>> _sessions;
-    std::unordered_set<std::string> _blacklist;
-    mutable std::mutex _sessions_mutex;
+    std::unique_ptr<session_store> _store;
+    std::array<shard, SHARDS> _shards;
+    snapshot_ptr<blacklist> _blacklist;
+    std::mutex _blacklist_update_mutex;
+
+    // Zero when unbounded. A shard may hold a little more than its even share, so that uneven hashing does not
+    // refuse sessions long before the total limit is reached.
+    size_t _max_sessions = 0;
+    size_t _shard_capacity = 0;
+
+    uint64_t _session_timeout_ticks;
+    int _expiry_timer_fd;
+    std::jthread _expiry_thread;
 
     std::atomic<bool> _shutdown_requested{false};
+
+    std::atomic<drain_progress::state> _drain_state{drain_progress::state::idle};
+    std::atomic<size_t> _drain_total{0};
+    std::atomic<size_t> _drain_released{0};
+    std::atomic<uint32_t> _drain_rate{0};
+    std::atomic<std::chrono::steady_clock::rep> _drain_started_at{0};
+    std::atomic<std::chrono::steady_clock::rep> _drain_finished_at{0};
+
+    // Written by every creation and removal, so kept off the lines the rest of the manager reads.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> _session_count{0};
 };
@@ -0,0 +1,154 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <session_store.hpp>
+
+session_store::session_store(const std::filesystem::path &path) {
+    _fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        throw session_store_exception("Cannot open session state file " + path.string() + ": " + strerror(errno));
+    }
+
+    struct stat info {};
+    if (fstat(_fd, &info) < 0) {
+        int error = errno;
+        cleanup();
+        throw session_store_exception("Cannot stat session state file " + path.string() + ": " + strerror(error));
+    }
+
+    // Reserve address space for the largest store up front; only the part backed by the file is ever touched.
+    _mapping_size = HEADER_BYTES + MAX_EXTENTS * EXTENT_BYTES;
+    void *mapping = mmap(nullptr, _mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, _fd, 0);
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        cleanup();
+        throw session_store_exception("Cannot map session state file " + path.string() + ": " + strerror(error));
+    }
+    _mapping = static_cast<char *>(mapping);
+
+    try {
+        load(path, static_cast<size_t>(info.st_size));
+    } catch (...) {
+        cleanup();
+        throw;
+    }
+
+    header initial{.magic = MAGIC, .record_size = sizeof(session_record), .extent_records = EXTENT_RECORDS};
+    std::memcpy(_mapping, &initial, sizeof(initial));
+}
+
+session_store::~session_store() { cleanup(); }
+
+size_t session_store::extents() const {
+    std::lock_guard<std::mutex> lock(_extents_mutex);
+    return _extents;
+}
+
+void session_store::region::write(uint32_t slot, const session_record &record) {
+    if (_store == nullptr) {
+        return;
+    }
+
+    session_record *target = find(slot);
+    target->created_at_ms = record.created_at_ms;
+    target->expires_at_ms = record.expires_at_ms;
+    target->imsi = record.imsi;
+}
+
+void session_store::region::clear(uint32_t slot) {
+    if (_store == nullptr) {
+        return;
+    }
+
+    find(slot)->imsi = 0;
+}
+
+void session_store::region::reserve(uint32_t slots) {
+    if (_store == nullptr || slots == 0) {
+        return;
+    }
+
+    (void) find(slots - 1);
+}
+
+session_record *session_store::region::find(uint32_t slot) {
+    // Shard slots are dense, so the region grows by at most one extent at a time.
+    size_t index = slot / EXTENT_RECORDS;
+    while (index >= _extents.size()) {
+        _extents.push_back(_store->allocate_extent());
+    }
+    return _store->extent(_extents[index]) + slot % EXTENT_RECORDS;
+}
+
+uint32_t session_store::allocate_extent() {
+    std::lock_guard<std::mutex> lock(_extents_mutex);
+
+    if (_restorable_extents == 0 && not _free_extents.empty()) {
+        uint32_t reused = _free_extents.back();
+        _free_extents.pop_back();
+        return reused;
+    }
+
+    if (_extents == MAX_EXTENTS) {
+        throw session_store_exception("Session state file is full");
+    }
+
+    resize(_extents + 1);
+    uint32_t grown = static_cast<uint32_t>(_extents - 1);
+    madvise(extent(grown), EXTENT_BYTES, MADV_POPULATE_WRITE);
+    return grown;
+}
+
+session_record *session_store::extent(uint32_t index) const {
+    return reinterpret_cast<session_record *>(_mapping + HEADER_BYTES + index * EXTENT_BYTES);
+}
+
+void session_store::load(const std::filesystem::path &path, size_t file_size) {
+    if (file_size == 0) {
+        resize(0);
+        return;
+    }
+
+    header existing{};
+    if (file_size >= HEADER_BYTES) {
+        std::memcpy(&existing, _mapping, sizeof(existing));
+    }
+
+    if (existing.magic != MAGIC || existing.record_size != sizeof(session_record) ||
+        existing.extent_records != EXTENT_RECORDS || (file_size - HEADER_BYTES) % EXTENT_BYTES != 0) {
+        throw session_store_exception("Not a session state file: " + path.string());
+    }
+
+    _extents = (file_size - HEADER_BYTES) / EXTENT_BYTES;
+
+    // One call maps the whole file instead of a page fault per page; kernels without it just fault as before.
+    madvise(_mapping, file_size, MADV_POPULATE_WRITE);
+
+    // Restored sessions are written back into these extents, already mapped, without growing the file.
+    _restorable_extents = _extents;
+    for (size_t i = _extents; i > 0; --i) {
+        _free_extents.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+void session_store::resize(size_t extents) {
+    if (ftruncate(_fd, static_cast<off_t>(HEADER_BYTES + extents * EXTENT_BYTES)) < 0) {
+        throw session_store_exception("Cannot resize session state file: " + std::string(strerror(errno)));
+    }
+    _extents = extents;
+}
+
+void session_store::cleanup() {
+    if (_mapping != nullptr) {
+        munmap(_mapping, _mapping_size);
+        _mapping = nullptr;
+    }
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class session_store_exception : public std::runtime_error {
+public:
+    explicit session_store_exception(const std::string &message) :
+        std::runtime_error("session_store_exception: " + message) {}
+};
+
+// One session as persisted; a zero IMSI marks a free record. Times are milliseconds since the Unix epoch, so they
+// stay meaningful across a restart.
+struct session_record {
+    uint64_t imsi = 0; // packed IMSI
+    int64_t created_at_ms = 0;
+    int64_t expires_at_ms = 0;
+};
+
+// Sessions mirrored into a memory-mapped file so that a restarted server can take them back. The file is a page of
+// header followed by extents of fixed-size records; each region (one per session shard) owns whole extents and
+// addresses its records by the shard's own slot numbers, so an update is a plain store into the mapping under the
+// lock the shard already holds. The whole address range is mapped once and the file grows underneath it, so
+// records never move.
+//
+// Opening the file keeps its records for restore() and its extents for reuse; regions only get extents back once
+// restore() has emptied them.
+class session_store {
+public:
+    static constexpr size_t EXTENT_RECORDS = 4096;
+
+    class region {
+    public:
+        region() = default;
+
+        region(const region &) = delete;
+        region &operator=(const region &) = delete;
+
+        void attach(session_store &store) { _store = &store; }
+        // Takes the extents for slots below `slots` now, so that writing them never grows the file.
+        void reserve(uint32_t slots);
+
+        void write(uint32_t slot, const session_record &record);
+        void clear(uint32_t slot);
+
+    private:
+        [[nodiscard]] session_record *find(uint32_t slot);
+
+        session_store *_store = nullptr;
+        std::vector<uint32_t> _extents;
+    };
+
+    explicit session_store(const std::filesystem::path &path);
+    ~session_store();
+
+    session_store(const session_store &) = delete;
+    session_store &operator=(const session_store &) = delete;
+    session_store(session_store &&) = delete;
+    session_store &operator=(session_store &&) = delete;
+
+    // Calls `visit` with every record that was live in the file when it was opened, straight from the mapping, then
+    // empties them; later calls find nothing.
+    template<typename F>
+    void restore(F &&visit) {
+        session_record *first = extent(0);
+        size_t records = _restorable_extents * EXTENT_RECORDS;
+
+        for (size_t i = 0; i < records; ++i) {
+            if (first[i].imsi != 0) {
+                visit(static_cast<const session_record &>(first[i]));
+            }
+        }
+
+        std::fill(first, first + records, session_record{});
+        _restorable_extents = 0;
+    }
+
+    // Records restore() will look at; an upper bound on the sessions it finds.
+    [[nodiscard]] size_t restorable_records() const { return _restorable_extents * EXTENT_RECORDS; }
+
+    // Extents in the file, whether in use or not.
+    [[nodiscard]] size_t extents() const;
+
+private:
+    static constexpr size_t HEADER_BYTES = 4096;
+    static constexpr size_t EXTENT_BYTES = EXTENT_RECORDS * sizeof(session_record);
+    static constexpr size_t MAX_EXTENTS = 1 << 16;
+    static constexpr uint64_t MAGIC = 0x3153534553574750ull; // "PGWSESS1" in file byte order
+
+    struct header {
+        uint64_t magic;
+        uint64_t record_size;
+        uint64_t extent_records;
+    };
+
+    [[nodiscard]] uint32_t allocate_extent();
+    [[nodiscard]] session_record *extent(uint32_t index) const;
+    void load(const std::filesystem::path &path, size_t file_size);
+    void resize(size_t extents);
+    void cleanup();
+
+private:
+    int _fd = -1;
+    char *_mapping = nullptr;
+    size_t _mapping_size = 0;
+
+    mutable std::mutex _extents_mutex;
+    size_t _extents = 0;
+    std::vector<uint32_t> _free_extents;
+    size_t _restorable_extents = 0;
+};
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+#include <session_table.hpp>
+
+namespace {
+    template<typename T>
+    void relocate(std::vector<T, page_allocator<T>> &items, size_t capacity, page_options options) {
+        std::vector<T, page_allocator<T>> relocated{page_allocator<T>(options)};
+        relocated.reserve(std::max(capacity, items.size()));
+        relocated.assign(items.begin(), items.end());
+        items = std::move(relocated);
+    }
+} // namespace
+
+session_table::session_table(size_t reserve) :
+    _index(std::make_unique<index_array>(std::bit_ceil(std::max(MIN_INDEX_SIZE, reserve + reserve / 7 + 1)),
+                                         page_options{})) {
+    _published.store(_index.get(), std::memory_order_release);
+
+    _slots.reserve(reserve);
+    _sessions.reserve(reserve);
+    _owners.reserve(reserve);
+}
+
+void session_table::reserve(size_t sessions) {
+    if (sessions * 8 > _index->size() * 7) {
+        begin_write();
+        grow_index(std::bit_ceil(sessions + sessions / 7 + 1));
+        end_write();
+    }
+
+    _slots.reserve(sessions);
+    _sessions.reserve(sessions);
+    _owners.reserve(sessions);
+}
+
+void session_table::preallocate(size_t sessions, page_options options) {
+    _page_options = options;
+
+    begin_write();
+    grow_index(std::bit_ceil(std::max({MIN_INDEX_SIZE, _index->size(), sessions + sessions / 7 + 1})));
+    end_write();
+
+    relocate(_slots, sessions, options);
+    relocate(_sessions, sessions, options);
+    relocate(_owners, sessions, options);
+}
+
+session_handle session_table::insert(packed_imsi imsi) {
+    // Without tombstones the first empty entry of the probe run is where the IMSI goes, so one walk both checks for
+    // a duplicate and finds the place.
+    size_t position = vacancy(*_index, imsi.packed());
+    if (_index->key(position) == imsi.packed()) {
+        return {};
+    }
+
+    begin_write();
+
+    // Keep the load factor at or below 7/8 so probe runs stay short.
+    if ((_sessions.size() + 1) * 8 > _index->size() * 7) {
+        grow_index(_index->size() * 2);
+        position = vacancy(*_index, imsi.packed());
+    }
+
+    uint32_t slot_id;
+    if (_free_slot != session_handle::NIL) {
+        slot_id = _free_slot;
+        _free_slot = _slots[slot_id].dense;
+    } else {
+        slot_id = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    }
+
+    _slots[slot_id].dense = static_cast<uint32_t>(_sessions.size());
+    _sessions.emplace_back(imsi);
+    _owners.push_back(slot_id);
+
+    index_entry &entry = _index->entries[position];
+    entry.slot = slot_id;
+    entry.key.store(imsi.packed(), std::memory_order_release);
+
+    end_write();
+
+    return {.slot = slot_id, .generation = _slots[slot_id].generation};
+}
+
+session_handle session_table::find(packed_imsi imsi) const {
+    size_t position = find_index(imsi);
+    if (position == NOT_FOUND) {
+        return {};
+    }
+
+    uint32_t slot_id = _index->entries[position].slot;
+    return {.slot = slot_id, .generation = _slots[slot_id].generation};
+}
+
+bool session_table::concurrent_contains(packed_imsi imsi) const {
+    while (true) {
+        uint64_t sequence = _sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            // A change is in flight; its probe run may be half shifted.
+            continue;
+        }
+
+        // The probe loads keys with acquire, so the sequence load below cannot move ahead of them, and a key stored
+        // by a change in flight brings that change's odd sequence along with it.
+        const index_array *index = _published.load(std::memory_order_acquire);
+        bool found = probe(*index, imsi.packed()) != NOT_FOUND;
+
+        if (_sequence.load(std::memory_order_relaxed) == sequence) {
+            return found;
+        }
+    }
+}
+
+session *session_table::get(session_handle handle) {
+    return const_cast<session *>(static_cast<const session_table *>(this)->get(handle));
+}
+
+const session *session_table::get(session_handle handle) const {
+    // Generations advance when a slot is freed, so only a live session's own handle matches.
+    if (handle.slot >= _slots.size() || _slots[handle.slot].generation != handle.generation) {
+        return nullptr;
+    }
+    return &_sessions[_slots[handle.slot].dense];
+}
+
+bool session_table::erase(session_handle handle) {
+    const session *target = get(handle);
+    if (target == nullptr) {
+        return false;
+    }
+
+    remove(handle.slot, find_index(target->get_imsi()));
+    return true;
+}
+
+bool session_table::erase(packed_imsi imsi) {
+    size_t position = find_index(imsi);
+    if (position == NOT_FOUND) {
+        return false;
+    }
+
+    remove(_index->entries[position].slot, position);
+    return true;
+}
+
+size_t session_table::memory_usage() const {
+    size_t index_bytes = _index->size() * sizeof(index_entry);
+    for (const auto &retired: _retired) {
+        index_bytes += retired->size() * sizeof(index_entry);
+    }
+
+    return index_bytes + _slots.capacity() * sizeof(slot) + _sessions.capacity() * sizeof(session) +
+           _owners.capacity() * sizeof(uint32_t);
+}
+
+size_t session_table::probe(const index_array &index, uint64_t key) {
+    // Bounded by one lap: a lock-free reader racing a shift may never see the empty entry that ends its run, and
+    // the sequence check discards whatever it returns then.
+    size_t position = home_of(index, key);
+    for (size_t step = 0; step <= index.mask; ++step) {
+        uint64_t stored = index.key(position);
+        if (stored == key) {
+            return position;
+        }
+        if (stored == 0) {
+            return NOT_FOUND;
+        }
+        position = (position + 1) & index.mask;
+    }
+    return NOT_FOUND;
+}
+
+size_t session_table::vacancy(const index_array &index, uint64_t key) {
+    // The entry holding `key`, or the empty one that ends its probe run.
+    size_t position = home_of(index, key);
+    while (true) {
+        uint64_t stored = index.key(position);
+        if (stored == 0 || stored == key) {
+            return position;
+        }
+        position = (position + 1) & index.mask;
+    }
+}
+
+size_t session_table::home_of(const index_array &index, uint64_t key) {
+    return std::hash<packed_imsi>{}(packed_imsi::from_packed(key)) & index.mask;
+}
+
+void session_table::begin_write() {
+    // Odd while the index is changing. Index keys are stored with release, so a reader that loads one also sees
+    // the bump; no fence is needed, and the thread sanitizer can follow every step.
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void session_table::end_write() {
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void session_table::erase_index(size_t position) {
+    // Backward-shift deletion: pull later members of the probe run into the hole unless that would move one in
+    // front of its home position.
+    index_array &index = *_index;
+    size_t hole = position;
+    size_t next = position;
+
+    while (true) {
+        next = (next + 1) & index.mask;
+        uint64_t key = index.key(next);
+        if (key == 0) {
+            break;
+        }
+
+        size_t home = home_of(index, key);
+        bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (not stays) {
+            index.entries[hole].slot = index.entries[next].slot;
+            index.entries[hole].key.store(key, std::memory_order_release);
+            hole = next;
+        }
+    }
+
+    index.entries[hole].key.store(0, std::memory_order_release);
+}
+
+void session_table::grow_index(size_t size) {
+    auto grown = std::make_unique<index_array>(size, _page_options);
+
+    for (size_t i = 0; i < _index->size(); ++i) {
+        uint64_t key = _index->key(i);
+        if (key == 0) {
+            continue;
+        }
+
+        size_t position = vacancy(*grown, key);
+        grown->entries[position].slot = _index->entries[i].slot;
+        grown->entries[position].key.store(key, std::memory_order_relaxed);
+    }
+
+    _published.store(grown.get(), std::memory_order_release);
+    _retired.push_back(std::move(_index));
+    _index = std::move(grown);
+}
+
+void session_table::remove(uint32_t slot_id, size_t index_position) {
+    begin_write();
+
+    uint32_t dense = _slots[slot_id].dense;
+    uint32_t last = static_cast<uint32_t>(_sessions.size() - 1);
+
+    // Keep the slab dense by moving the last session into the hole and repointing its slot.
+    if (dense != last) {
+        _sessions[dense] = _sessions[last];
+        _owners[dense] = _owners[last];
+        _slots[_owners[dense]].dense = dense;
+    }
+    _sessions.pop_back();
+    _owners.pop_back();
+
+    slot &freed = _slots[slot_id];
+    freed.generation = freed.generation == std::numeric_limits<uint32_t>::max() ? 1 : freed.generation + 1;
+    freed.dense = _free_slot;
+    _free_slot = slot_id;
+
+    erase_index(index_position);
+
+    end_write();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <packed_imsi.hpp>
+#include <page_allocator.hpp>
+#include <session.hpp>
+
+// Refers to a session for as long as it lives; a handle to an erased session stops resolving even after its slot
+// is reused.
+struct session_handle {
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+    uint32_t slot = NIL;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool valid() const { return slot != NIL; }
+
+    friend bool operator==(const session_handle &, const session_handle &) = default;
+};
+
+// Session storage without per-session allocations. Sessions sit densely in a slab (so draining and iteration walk
+// contiguous memory) behind a slot map that keeps handles stable across the swap-removal of other sessions; an
+// open-addressing, linear-probing index maps the packed IMSI to its slot. Erasure shifts the probe run back, so the
+// index never accumulates tombstones.
+//
+// Callers serialize all other access with a lock, but concurrent_contains() may run at any time without it: index
+// keys are atomics, every change is bracketed by a sequence counter (a seqlock), and readers retry when a change
+// overlapped their probe. Index arrays replaced by growth are retired rather than freed, so a reader that is still
+// probing one never touches freed memory; geometric growth keeps them smaller than the live index in total.
+class session_table {
+public:
+    explicit session_table(size_t reserve = 0);
+
+    session_table(const session_table &) = delete;
+    session_table &operator=(const session_table &) = delete;
+
+    // Sizes the index and the slab for `sessions` in total, so that many inserts neither rehash nor reallocate.
+    void reserve(size_t sessions);
+    // As reserve(), but moves the storage onto memory backed as `options` asks; growth past `sessions` keeps using it.
+    void preallocate(size_t sessions, page_options options);
+
+    // Returns an invalid handle if the IMSI already has a session.
+    [[nodiscard]] session_handle insert(packed_imsi imsi);
+    [[nodiscard]] session_handle find(packed_imsi imsi) const;
+    [[nodiscard]] bool contains(packed_imsi imsi) const { return find_index(imsi) != NOT_FOUND; }
+    // Starts loading the index entry an insert or lookup of `imsi` would begin at; bulk loads call it a few keys
+    // ahead.
+    void prefetch(packed_imsi imsi) const { __builtin_prefetch(&_index->entries[home_of(*_index, imsi.packed())], 1); }
+    // Safe without the lock, concurrently with a writer; never blocks it.
+    [[nodiscard]] bool concurrent_contains(packed_imsi imsi) const;
+
+    // nullptr for a stale handle.
+    [[nodiscard]] session *get(session_handle handle);
+    [[nodiscard]] const session *get(session_handle handle) const;
+
+    bool erase(session_handle handle);
+    bool erase(packed_imsi imsi);
+
+    [[nodiscard]] std::span<const session> sessions() const { return _sessions; }
+    [[nodiscard]] size_t size() const { return _sessions.size(); }
+    [[nodiscard]] bool empty() const { return _sessions.empty(); }
+
+    // Bytes reserved by the index, the slot map and the slab.
+    [[nodiscard]] size_t memory_usage() const;
+
+private:
+    static constexpr size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+    static constexpr size_t MIN_INDEX_SIZE = 16;
+
+    struct index_entry {
+        std::atomic<uint64_t> key = 0; // packed IMSI; a valid IMSI has at least one digit, so 0 marks an empty entry
+        uint32_t slot = 0;
+    };
+
+    struct index_array {
+        index_array(size_t size, page_options options) :
+            mask(size - 1), entries(size, page_allocator<index_entry>(options)) {}
+
+        [[nodiscard]] size_t size() const { return mask + 1; }
+        // Acquire pairs with the writer's release stores for concurrent_contains(); on x86 both are plain moves.
+        [[nodiscard]] uint64_t key(size_t position) const {
+            return entries[position].key.load(std::memory_order_acquire);
+        }
+
+        size_t mask;
+        std::vector<index_entry, page_allocator<index_entry>> entries;
+    };
+
+    struct slot {
+        uint32_t dense = session_handle::NIL; // position in _sessions, or the next free slot while unused
+        uint32_t generation = 1;
+    };
+
+    [[nodiscard]] static size_t probe(const index_array &index, uint64_t key);
+    [[nodiscard]] static size_t vacancy(const index_array &index, uint64_t key);
+    [[nodiscard]] static size_t home_of(const index_array &index, uint64_t key);
+    [[nodiscard]] size_t find_index(packed_imsi imsi) const { return probe(*_index, imsi.packed()); }
+    void begin_write();
+    void end_write();
+    void erase_index(size_t position);
+    void grow_index(size_t size);
+    void remove(uint32_t slot_id, size_t index_position);
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // All a lock-free lookup reads besides the index itself; kept apart from the writer's bookkeeping.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> _sequence{0};
+    std::atomic<const index_array *> _published{nullptr};
+
+    alignas(CACHE_LINE_SIZE) std::unique_ptr<index_array> _index;
+    std::vector<std::unique_ptr<index_array>> _retired;
+
+    page_options _page_options;
+
+    std::vector<slot, page_allocator<slot>> _slots;
+    uint32_t _free_slot = session_handle::NIL;
+
+    std::vector<session, page_allocator<session>> _sessions;
+    std::vector<uint32_t, page_allocator<uint32_t>> _owners; // slot of each dense session
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Owns an immutable T that is replaced wholesale: readers pin the current snapshot without locking, a writer
+// publishes a new one with an atomic pointer swap and frees the old one only after every reader that could still
+// see it has let go.
+//
+// Readers announce themselves in one of two counters picked by the parity of an epoch, spread over stripes so
+// threads rarely share a cache line. After the swap the writer flips the epoch and waits for the counters of the
+// old parity to drain, twice, so both parities have been empty at some point after the swap; any reader that
+// arrives later loads the new pointer. Readers never wait; publish() waits for in-flight readers, so keep them short.
+template<typename T>
+class snapshot_ptr {
+public:
+    // Pins a snapshot for as long as it lives.
+    class reader {
+    public:
+        reader(const reader &) = delete;
+        reader &operator=(const reader &) = delete;
+
+        ~reader() { _counter->fetch_sub(1, std::memory_order_release); }
+
+        const T &operator*() const { return *_value; }
+        const T *operator->() const { return _value; }
+
+    private:
+        friend class snapshot_ptr;
+
+        explicit reader(const snapshot_ptr &owner) :
+            _counter(&owner._stripes[stripe()].readers[owner._epoch.load() & 1]) {
+            _counter->fetch_add(1);
+            _value = owner._current.load();
+        }
+
+        std::atomic<uint64_t> *_counter;
+        const T *_value;
+    };
+
+    explicit snapshot_ptr(std::unique_ptr<const T> initial) : _current(initial.release()) {}
+    ~snapshot_ptr() { delete _current.load(); }
+
+    snapshot_ptr(const snapshot_ptr &) = delete;
+    snapshot_ptr &operator=(const snapshot_ptr &) = delete;
+
+    [[nodiscard]] reader read() const { return reader(*this); }
+
+    // Callers serialize publish() among themselves.
+    void publish(std::unique_ptr<const T> next) {
+        std::unique_ptr<const T> previous(_current.exchange(next.release()));
+
+        for (int phase = 0; phase < 2; ++phase) {
+            uint64_t parity = _epoch.fetch_add(1) & 1;
+            while (readers(parity) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t STRIPES = 16;
+
+    struct alignas(CACHE_LINE_SIZE) stripe_counters {
+        std::array<std::atomic<uint64_t>, 2> readers{};
+    };
+
+    static size_t stripe() {
+        static std::atomic<size_t> next_stripe{0};
+        thread_local size_t assigned = next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return assigned;
+    }
+
+    [[nodiscard]] uint64_t readers(uint64_t parity) const {
+        uint64_t total = 0;
+        for (const auto &counters: _stripes) {
+            total += counters.readers[parity].load();
+        }
+        return total;
+    }
+
+private:
+    std::atomic<const T *> _current;
+    std::atomic<uint64_t> _epoch{0};
+    mutable std::array<stripe_counters, STRIPES> _stripes;
+};
@@ -38,8 +38,12 @@ thread_pool::thread_pool(size_t threads_num, std::shared_ptr<logger> logger) : _
 
 thread_pool::~thread_pool() {
     _logger->debug("Thread pool destruction started, requesting stop for all workers");
-    for (auto &w: _workers) {
-        w.request_stop();
+    {
+        // Under the lock, so that a worker between checking for stop and waiting cannot miss it.
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        for (auto &w: _workers) {
+            w.request_stop();
+        }
     }
 
     _cv.notify_all();
@@ -41,8 +41,9 @@ public:
 private:
     std::shared_ptr<logger> _logger;
 
-    std::vector<std::jthread> _workers;
     std::queue<std::function<void()>> _tasks;
     std::mutex _queue_mutex;
     std::condition_variable _cv;
+    // Last, so that the workers are joined before the queue they wait on is destroyed.
+    std::vector<std::jthread> _workers;
 };
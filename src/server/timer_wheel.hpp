@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <page_allocator.hpp>
+
+// Hierarchical timer wheel: LEVELS wheels of SLOTS buckets, each level covering SLOTS times the range of the
+// one below. Timers live in a slab of intrusive doubly-linked nodes, so schedule and cancel are O(1) and a tick
+// only touches the due bucket (plus an occasional cascade of one higher-level bucket).
+template<typename T>
+class timer_wheel {
+public:
+    using timer_id = uint64_t;
+    static constexpr timer_id invalid_timer = 0;
+
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint64_t MAX_DELAY = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+    explicit timer_wheel(size_t reserve = 0) {
+        _nodes.reserve(BUCKETS + reserve);
+        _nodes.resize(BUCKETS);
+        for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket) {
+            _nodes[bucket].prev = bucket;
+            _nodes[bucket].next = bucket;
+        }
+    }
+
+    timer_wheel(const timer_wheel &) = delete;
+    timer_wheel &operator=(const timer_wheel &) = delete;
+
+    // Fires on the tick `delay` ticks from now; a zero delay fires on the next tick.
+    [[nodiscard]] timer_id schedule(uint64_t delay, T payload) {
+        uint32_t index = allocate();
+        node &timer = _nodes[index];
+
+        timer.expires_at = _now + std::clamp<uint64_t>(delay, 1, MAX_DELAY);
+        timer.payload = std::move(payload);
+        place(index);
+
+        _size++;
+        return (static_cast<uint64_t>(timer.generation) << 32) | index;
+    }
+
+    bool cancel(timer_id id) {
+        auto index = static_cast<uint32_t>(id);
+        auto generation = static_cast<uint32_t>(id >> 32);
+
+        if (index < BUCKETS || index >= _nodes.size() || _nodes[index].generation != generation ||
+            not _nodes[index].linked) {
+            return false;
+        }
+
+        unlink(index);
+        release(index);
+        _size--;
+        return true;
+    }
+
+    // Moves time forward by `ticks`, calling on_expired(timer_id, T &&) for every timer that comes due.
+    template<typename F>
+    void advance(uint64_t ticks, F &&on_expired) {
+        for (uint64_t i = 0; i < ticks; ++i) {
+            _now++;
+
+            for (uint32_t level = LEVELS - 1; level > 0; --level) {
+                if ((_now & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) == 0) {
+                    cascade(bucket_of(level, _now));
+                }
+            }
+
+            uint32_t head = bucket_of(0, _now);
+            while (_nodes[head].next != head) {
+                uint32_t index = _nodes[head].next;
+                timer_id id = (static_cast<uint64_t>(_nodes[index].generation) << 32) | index;
+
+                unlink(index);
+                T payload = std::move(_nodes[index].payload);
+                release(index);
+                _size--;
+
+                on_expired(id, std::move(payload));
+            }
+        }
+    }
+
+    [[nodiscard]] uint64_t now() const { return _now; }
+    void reserve(size_t timers) { _nodes.reserve(BUCKETS + timers); }
+    // As reserve(), but moves the timer slab onto memory backed as `options` asks.
+    void preallocate(size_t timers, page_options options) {
+        std::vector<node, page_allocator<node>> nodes{page_allocator<node>(options)};
+        nodes.reserve(std::max(BUCKETS + timers, _nodes.size()));
+        nodes.assign(_nodes.begin(), _nodes.end());
+        _nodes = std::move(nodes);
+    }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+private:
+    static constexpr uint32_t BUCKETS = SLOTS * LEVELS;
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+    struct node {
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 1;
+        bool linked = false;
+        uint64_t expires_at = 0;
+        T payload{};
+    };
+
+    static uint32_t bucket_of(uint32_t level, uint64_t tick) {
+        return level * SLOTS + static_cast<uint32_t>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    }
+
+    void place(uint32_t index) {
+        node &timer = _nodes[index];
+        uint64_t expires_at = std::max(timer.expires_at, _now);
+        uint64_t delay = expires_at - _now;
+
+        uint32_t level = 0;
+        while (level + 1 < LEVELS && delay >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+
+        // A timer due now (only possible while cascading) goes to the bucket that is about to be drained.
+        link(bucket_of(level, delay == 0 ? _now : expires_at), index);
+    }
+
+    void cascade(uint32_t head) {
+        uint32_t index = _nodes[head].next;
+        _nodes[head].prev = head;
+        _nodes[head].next = head;
+
+        while (index != head) {
+            uint32_t next = _nodes[index].next;
+            _nodes[index].linked = false;
+            place(index);
+            index = next;
+        }
+    }
+
+    void link(uint32_t head, uint32_t index) {
+        node &timer = _nodes[index];
+        timer.prev = _nodes[head].prev;
+        timer.next = head;
+        _nodes[timer.prev].next = index;
+        _nodes[head].prev = index;
+        timer.linked = true;
+    }
+
+    void unlink(uint32_t index) {
+        node &timer = _nodes[index];
+        _nodes[timer.prev].next = timer.next;
+        _nodes[timer.next].prev = timer.prev;
+        timer.prev = NIL;
+        timer.next = NIL;
+        timer.linked = false;
+    }
+
+    uint32_t allocate() {
+        if (_free_head != NIL) {
+            uint32_t index = _free_head;
+            _free_head = _nodes[index].next;
+            return index;
+        }
+
+        _nodes.emplace_back();
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    void release(uint32_t index) {
+        node &timer = _nodes[index];
+        timer.payload = T{};
+        timer.generation = timer.generation == std::numeric_limits<uint32_t>::max() ? 1 : timer.generation + 1;
+        timer.next = _free_head;
+        _free_head = index;
+    }
+
+private:
+    std::vector<node, page_allocator<node>> _nodes;
+    uint32_t _free_head = NIL;
+    uint64_t _now = 0;
+    size_t _size = 0;
+};
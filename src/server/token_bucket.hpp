@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Paces work to `rate` units per second however often, and however late, it is polled: credit accrues with the
+// elapsed time, whole tokens are handed out and the remainder carries over, so the long-run rate is exact even when
+// a single poll earns less than one token. At most `burst` tokens pile up while nobody takes them. Credit is kept
+// in token-nanoseconds, so there is no rounding drift.
+class token_bucket {
+public:
+    using clock = std::chrono::steady_clock;
+
+    token_bucket(uint64_t rate, uint64_t burst, clock::time_point now) :
+        _rate(std::max<uint64_t>(rate, 1)), _max_credit(std::max<uint64_t>(burst, 1) * NANOS_PER_TOKEN), _last(now) {}
+
+    [[nodiscard]] size_t take(clock::time_point now) {
+        if (now > _last) {
+            auto elapsed =
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _last).count());
+            // Clamp before multiplying so that a long pause cannot overflow.
+            elapsed = std::min(elapsed, _max_credit / _rate + 1);
+            _credit = std::min(_max_credit, _credit + elapsed * _rate);
+            _last = now;
+        }
+
+        uint64_t whole = _credit / NANOS_PER_TOKEN;
+        _credit -= whole * NANOS_PER_TOKEN;
+        return static_cast<size_t>(whole);
+    }
+
+    [[nodiscard]] uint64_t rate() const { return _rate; }
+
+private:
+    static constexpr uint64_t NANOS_PER_TOKEN = 1'000'000'000;
+
+    uint64_t _rate;
+    uint64_t _max_credit;
+    uint64_t _credit = 0;
+    clock::time_point _last;
+};
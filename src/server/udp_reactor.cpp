@@ -0,0 +1,972 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <format>
+#include <linux/sock_diag.h>
+#include <poll.h>
+#include <span>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <udp_reactor.hpp>
+#include <udp_server.hpp>
+
+#include <config.hpp>
+#include <io_uring_ring.hpp>
+#include <logger.hpp>
+#include <packet_filter.hpp>
+#include <packet_manager.hpp>
+#include <response_cache.hpp>
+#include <udp_response.hpp>
+
+
+udp_reactor::udp_reactor(std::shared_ptr<config> config, std::shared_ptr<packet_manager> packet_manager,
+                         std::shared_ptr<logger> logger, uint32_t id, bool reuse_port) :
+    _config(std::move(config)), _packet_manager(std::move(packet_manager)), _logger(std::move(logger)), _id(id),
+    _socket_fd(-1), _epoll_fd(-1), _stop_event_fd(-1),
+    _packet_pool(_config->get_udp_buffer_pool_size().value_or(DEFAULT_BUFFER_POOL_SIZE), SLOT_SIZE),
+    _request_queue(_packet_pool.capacity()), _response_queue(_packet_pool.capacity()), _batch_size(1),
+    _inline_responses(false), _kernel_filter(false), _epollout_enabled(false),
+    _time_budget(DEFAULT_TIME_BUDGET_US), _busy_poll_window(0), _packet_budget(MIN_PACKET_BUDGET),
+    _engine(io_engine::epoll), _uring_recv_msg{}, _uring_recv_armed(false), _uring_sends_queued(false) {
+    static_assert(RECVMSG_HEADER_SIZE == sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in));
+
+    auto ip = _config->get_ip().value();
+    auto port = _config->get_port().value();
+    _batch_size = std::clamp<uint32_t>(_config->get_udp_batch_size().value_or(1), 1, _packet_pool.capacity());
+    _inline_responses = _config->get_udp_inline_responses().value_or(false);
+    _kernel_filter = _config->get_udp_kernel_filter().value_or(false);
+
+    uint32_t cache_size = _config->get_udp_retransmit_cache_size().value_or(DEFAULT_RETRANSMIT_CACHE_SIZE);
+    uint32_t cache_ttl_ms = _config->get_udp_retransmit_ttl_ms().value_or(DEFAULT_RETRANSMIT_TTL_MS);
+    if (cache_size > 0 && cache_ttl_ms > 0) {
+        _response_cache = std::make_unique<response_cache>(cache_size, std::chrono::milliseconds(cache_ttl_ms));
+    }
+    _time_budget = std::chrono::microseconds(_config->get_udp_batch_budget_us().value_or(DEFAULT_TIME_BUDGET_US));
+    _busy_poll_window = std::chrono::microseconds(_config->get_udp_busy_poll_us().value_or(0));
+
+    auto engine = _config->get_udp_io_engine().value_or("epoll");
+    if (engine == "io_uring") {
+        _engine = io_engine::io_uring;
+    } else if (engine != "epoll") {
+        _logger->warning("Unknown UDP I/O engine '" + engine + "', using epoll");
+    }
+
+    _logger->debug("Initializing UDP reactor " + std::to_string(_id) + " on " + ip + ":" + std::to_string(port));
+
+    init_setup(ip, port, reuse_port);
+    setup_stop_event();
+    setup_batch_buffers();
+
+    _logger->info("Initialized UDP reactor " + std::to_string(_id) + " on " + ip + ":" + std::to_string(port) +
+                  " (engine: " + engine + ", kernel filter: " + (_kernel_filter ? "on" : "off") +
+                  ", busy poll: " + std::to_string(_busy_poll_window.count()) + "us, batch size: " +
+                  std::to_string(_batch_size) + ", receive buffers: " + std::to_string(_packet_pool.capacity()) + ")");
+}
+
+udp_reactor::~udp_reactor() {
+    _logger->info("Shutting down UDP reactor " + std::to_string(_id));
+
+    if (_socket_fd != -1) {
+        close(_socket_fd);
+        _logger->debug("Socket closed");
+    }
+    if (_epoll_fd != -1) {
+        close(_epoll_fd);
+        _logger->debug("Epoll fd closed");
+    }
+    if (_stop_event_fd != -1) {
+        close(_stop_event_fd);
+        _logger->debug("Stop event fd closed");
+    }
+
+    _logger->info("UDP reactor " + std::to_string(_id) + " destroyed");
+}
+
+void udp_reactor::init_setup(const std::string &ip, int port, bool reuse_port) {
+    _logger->debug("Creating UDP socket");
+    _socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_socket_fd < 0) {
+        _logger->fatal("Failed to create socket");
+        throw udp_server_exception("Failed to create socket");
+    }
+
+    sockaddr_in server_addr{};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip.c_str(), &server_addr.sin_addr) != 1) {
+        close(_socket_fd);
+        _logger->fatal("Invalid IP address: " + ip);
+        throw udp_server_exception("Invalid IP address");
+    }
+
+    if (reuse_port) {
+        _logger->debug("Enabling SO_REUSEPORT on socket");
+        int enable = 1;
+        if (setsockopt(_socket_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+            close(_socket_fd);
+            _logger->fatal("Failed to set SO_REUSEPORT: " + std::string(strerror(errno)));
+            throw udp_server_exception("Failed to set SO_REUSEPORT");
+        }
+    }
+
+    if (_kernel_filter) {
+        attach_packet_filter();
+    }
+
+    if (_busy_poll_window.count() > 0 && _config->get_udp_socket_busy_poll().value_or(false)) {
+        enable_socket_busy_poll();
+    }
+
+    _logger->debug("Binding socket to address");
+    if (bind(_socket_fd, (sockaddr *) &server_addr, sizeof(server_addr)) < 0) {
+        close(_socket_fd);
+        _logger->fatal("Failed to bind socket to " + ip + ":" + std::to_string(port));
+        throw udp_server_exception("Failed to bind socket");
+    }
+
+    _logger->debug("Setting socket to non-blocking mode");
+    int flags = fcntl(_socket_fd, F_GETFL, 0);
+    if (flags < 0) {
+        close(_socket_fd);
+        _logger->fatal("fcntl F_GETFL failed");
+        throw udp_server_exception("fcntl F_GETFL failed");
+    }
+    if (fcntl(_socket_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        close(_socket_fd);
+        _logger->fatal("fcntl F_SETFL O_NONBLOCK failed");
+        throw udp_server_exception("fcntl F_SETFL O_NONBLOCK failed");
+    }
+
+    _logger->debug("Creating epoll instance");
+    _epoll_fd = epoll_create1(0);
+    if (_epoll_fd < 0) {
+        close(_socket_fd);
+        _logger->fatal("Failed to create epoll");
+        throw udp_server_exception("Failed to create epoll");
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = _socket_fd;
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _socket_fd, &event) < 0) {
+        close(_socket_fd);
+        close(_epoll_fd);
+        _logger->fatal("Failed to add socket to epoll");
+        throw udp_server_exception("Failed to add socket to epoll");
+    }
+
+    _logger->debug("UDP reactor init_setup completed successfully");
+}
+
+void udp_reactor::attach_packet_filter() {
+    auto code = packet_filter::malformed_program();
+    sock_fprog program{static_cast<unsigned short>(code.size()), code.data()};
+
+    _logger->debug("Attaching malformed packet filter to socket");
+    if (setsockopt(_socket_fd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) < 0) {
+        _logger->warning("Failed to attach socket filter, malformed packets will be rejected in user space: " +
+                         std::string(strerror(errno)));
+        _kernel_filter = false;
+    }
+}
+
+bool udp_reactor::attach_steering_program(uint32_t reactors_num) {
+    auto code = packet_filter::steering_program(reactors_num);
+    sock_fprog program{static_cast<unsigned short>(code.size()), code.data()};
+
+    _logger->debug("Attaching IMSI steering program to reuseport group");
+    if (setsockopt(_socket_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) < 0) {
+        _logger->warning("Failed to attach IMSI steering program, falling back to kernel flow hashing: " +
+                         std::string(strerror(errno)));
+        return false;
+    }
+
+    return true;
+}
+
+void udp_reactor::enable_socket_busy_poll() {
+    // Lets the kernel poll the device queue from recvmmsg/epoll instead of waiting for the interrupt.
+    // Raising SO_BUSY_POLL above net.core.busy_read needs CAP_NET_ADMIN, so failures only disable it.
+    int busy_poll_us = static_cast<int>(_busy_poll_window.count());
+    if (setsockopt(_socket_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) < 0) {
+        _logger->warning("Failed to set SO_BUSY_POLL: " + std::string(strerror(errno)));
+        return;
+    }
+
+    int enable = 1;
+    if (setsockopt(_socket_fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &enable, sizeof(enable)) < 0) {
+        _logger->warning("Failed to set SO_PREFER_BUSY_POLL: " + std::string(strerror(errno)));
+    }
+}
+
+void udp_reactor::setup_stop_event() {
+    _logger->debug("Creating stop event fd");
+    _stop_event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_stop_event_fd < 0) {
+        close(_socket_fd);
+        close(_epoll_fd);
+        _logger->fatal("Failed to create stop event fd");
+        throw udp_server_exception("Failed to create stop event fd");
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = _stop_event_fd;
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _stop_event_fd, &event) < 0) {
+        close(_socket_fd);
+        close(_epoll_fd);
+        close(_stop_event_fd);
+        _logger->fatal("Failed to add stop event fd to epoll");
+        throw udp_server_exception("Failed to add stop event fd to epoll");
+    }
+
+    _logger->debug("Stop event fd setup completed");
+}
+
+void udp_reactor::setup_batch_buffers() {
+    if (_batch_size <= 1) {
+        _logger->debug("Batched datagram I/O disabled");
+        return;
+    }
+
+    _logger->debug("Allocating buffers for batched datagram I/O");
+
+    _rx_slots.resize(_batch_size);
+    _rx_addrs.resize(_batch_size);
+    _rx_iovecs.resize(_batch_size);
+    _rx_msgs.resize(_batch_size);
+    _tx_iovecs.resize(_batch_size);
+    _tx_msgs.resize(_batch_size);
+
+    for (uint32_t i = 0; i < _batch_size; ++i) {
+        _rx_msgs[i] = {};
+        _rx_msgs[i].msg_hdr.msg_name = &_rx_addrs[i];
+        _rx_msgs[i].msg_hdr.msg_iov = &_rx_iovecs[i];
+        _rx_msgs[i].msg_hdr.msg_iovlen = 1;
+
+        _tx_msgs[i] = {};
+        _tx_msgs[i].msg_hdr.msg_iov = &_tx_iovecs[i];
+        _tx_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+void udp_reactor::run() {
+    _logger->info("Starting UDP reactor " + std::to_string(_id) + " main loop");
+    _running.store(true);
+    _reported_at = std::chrono::steady_clock::now();
+
+    if (_engine == io_engine::io_uring && setup_uring()) {
+        run_uring();
+    } else {
+        run_epoll();
+    }
+
+    report_io_stats(true);
+    _logger->info("UDP reactor " + std::to_string(_id) + " main loop exited gracefully");
+}
+
+void udp_reactor::run_epoll() {
+    std::array<epoll_event, MAX_EVENTS> events;
+
+    while (_running.load()) {
+        int timeout = _request_queue.empty() ? -1 : 0;
+        if (timeout < 0 && _busy_poll_window.count() > 0 && spin_receive()) {
+            timeout = 0;
+        }
+
+        _logger->debug("Waiting for events...");
+        int event_count = epoll_wait(_epoll_fd, events.data(), MAX_EVENTS, timeout);
+
+        if (event_count < 0) {
+            if (errno == EINTR) {
+                _logger->debug("epoll_wait interrupted by signal");
+                continue;
+            }
+            _logger->error("epoll_wait error: " + std::string(strerror(errno)));
+            break;
+        }
+
+        _logger->debug("Received " + std::to_string(event_count) + " events");
+
+        for (int i = 0; i < event_count; ++i) {
+            epoll_event &event = events[i];
+
+            if (event.data.fd == _stop_event_fd) {
+                _logger->info("Received stop signal");
+                _running.store(false);
+
+                uint64_t val;
+                if (eventfd_read(_stop_event_fd, &val) < 0) {
+                    _logger->error("Failed to read from stop event fd: " + std::string(strerror(errno)));
+                }
+                break;
+            } else if (event.data.fd == _socket_fd) {
+                if (event.events & EPOLLIN) {
+                    receive_packets();
+                }
+
+                if ((event.events & EPOLLOUT) && not _response_queue.empty()) {
+                    flush_responses();
+                }
+            }
+        }
+
+        if (process_requests() > 0 && not _response_queue.empty()) {
+            if (_inline_responses && not _epollout_enabled) {
+                flush_responses();
+            }
+
+            if (not _response_queue.empty()) {
+                set_epollout(true);
+            }
+        }
+
+        report_io_stats(false);
+    }
+
+    // Requests are processed only while the response queue has room, so replies go out in the same loop. A pass that
+    // neither processes nor sends anything found the socket buffer full: wait a bounded time for it to drain.
+    _logger->info("Processing remaining requests and sending responses before shutdown...");
+    while (not _request_queue.empty() || not _response_queue.empty()) {
+        int32_t processed = process_requests();
+
+        size_t queued = _response_queue.size();
+        flush_responses();
+
+        if (processed > 0 || _response_queue.size() < queued) {
+            continue;
+        }
+
+        pollfd writable{.fd = _socket_fd, .events = POLLOUT, .revents = 0};
+        if (poll(&writable, 1, SHUTDOWN_SEND_TIMEOUT_MS) <= 0) {
+            _logger->warning("UDP reactor " + std::to_string(_id) + " socket stayed unwritable at shutdown, dropping " +
+                             std::to_string(_request_queue.size()) + " requests and " +
+                             std::to_string(_response_queue.size()) + " responses");
+            break;
+        }
+    }
+}
+
+bool udp_reactor::spin_receive() {
+    // Trades a pinned core for latency: poll the socket for a short window before sleeping in epoll_wait.
+    auto deadline = std::chrono::steady_clock::now() + _busy_poll_window;
+
+    do {
+        receive_packets();
+        if (not _request_queue.empty()) {
+            return true;
+        }
+    } while (_running.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline);
+
+    return false;
+}
+
+void udp_reactor::receive_packets() {
+    if (_batch_size > 1) {
+        read_packets_batched();
+    } else {
+        read_packets();
+    }
+}
+
+void udp_reactor::read_packets() {
+    sockaddr_in client_addr{};
+    socklen_t client_len = sizeof(client_addr);
+
+    while (true) {
+        packet_pool::slot_id slot = _packet_pool.acquire();
+        if (slot == packet_pool::invalid_slot) {
+            _logger->debug("Receive buffer pool exhausted, deferring reads");
+            break;
+        }
+
+        // With MSG_TRUNC recvfrom returns the datagram's real length, so an oversized one shows up as longer than the
+        // buffer instead of silently cut short.
+        std::span<uint8_t> buffer = _packet_pool.buffer(slot);
+        ssize_t bytes_received = recvfrom(_socket_fd, buffer.data(), BUFFER_SIZE, MSG_DONTWAIT | MSG_TRUNC,
+                                          (sockaddr *) &client_addr, &client_len);
+        _stats.rx_syscalls++;
+
+        if (bytes_received <= 0) {
+            _packet_pool.release(slot);
+
+            if (bytes_received == 0) {
+                _logger->debug("Received empty packet, ignoring");
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            _logger->error("recvfrom error: " + std::string(strerror(errno)));
+            break;
+        }
+
+        if (bytes_received > BUFFER_SIZE) {
+            _logger->error("Received packet larger than buffer, dropping");
+            _packet_pool.release(slot);
+            continue;
+        }
+
+        if (_logger->is_enabled(logger::log_level::debug)) {
+            char client_ip[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+            int client_port = ntohs(client_addr.sin_port);
+
+            _logger->debug("Received " + std::to_string(bytes_received) + " bytes from " + std::string(client_ip) +
+                           ":" + std::to_string(client_port));
+        }
+
+        (void) _request_queue.push({slot, 0, static_cast<uint16_t>(bytes_received), client_addr});
+        _stats.rx_packets++;
+    }
+}
+
+// Every pass receives into slots acquired for it; queued requests keep their slots until processed, so reissuing
+// recvmmsg within one wakeup never overwrites a datagram that is still waiting. Do not reuse a fixed set of buffers
+// across passes here.
+void udp_reactor::read_packets_batched() {
+    while (true) {
+        uint32_t slots = std::min<size_t>(_batch_size, _packet_pool.available());
+        if (slots == 0) {
+            _logger->debug("Receive buffer pool exhausted, deferring reads");
+            break;
+        }
+
+        for (uint32_t i = 0; i < slots; ++i) {
+            _rx_slots[i] = _packet_pool.acquire();
+
+            std::span<uint8_t> buffer = _packet_pool.buffer(_rx_slots[i]);
+            _rx_iovecs[i] = {buffer.data(), BUFFER_SIZE};
+            _rx_msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            _rx_msgs[i].msg_hdr.msg_flags = 0;
+        }
+
+        int received = recvmmsg(_socket_fd, _rx_msgs.data(), slots, MSG_DONTWAIT, nullptr);
+        _stats.rx_syscalls++;
+
+        uint32_t queued = 0;
+        for (int i = 0; i < received; ++i) {
+            const mmsghdr &msg = _rx_msgs[i];
+
+            if (msg.msg_len == 0) {
+                _logger->debug("Received empty packet, ignoring");
+                _packet_pool.release(_rx_slots[i]);
+                continue;
+            }
+
+            if (msg.msg_hdr.msg_flags & MSG_TRUNC) {
+                _logger->error("Received packet larger than buffer, dropping");
+                _packet_pool.release(_rx_slots[i]);
+                continue;
+            }
+
+            (void) _request_queue.push({_rx_slots[i], 0, static_cast<uint16_t>(msg.msg_len), _rx_addrs[i]});
+            queued++;
+        }
+
+        for (uint32_t i = std::max(received, 0); i < slots; ++i) {
+            _packet_pool.release(_rx_slots[i]);
+        }
+
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            _logger->error("recvmmsg error: " + std::string(strerror(errno)));
+            break;
+        }
+
+        _stats.rx_packets += queued;
+
+        if (static_cast<uint32_t>(received) < slots)
+            break;
+    }
+}
+
+void udp_reactor::send_pending_responses() {
+    int32_t sent_responses = 0;
+
+    while (not _response_queue.empty()) {
+        auto &resp = _response_queue.front();
+
+        ssize_t bytes_sent = sendto(_socket_fd, resp.data.data(), resp.data.size(), MSG_DONTWAIT,
+                                    (const sockaddr *) &resp.client_addr, sizeof(resp.client_addr));
+        _stats.tx_syscalls++;
+
+        if (bytes_sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            _logger->error("sendto error: " + std::string(strerror(errno)));
+            _response_queue.pop();
+            continue;
+        }
+
+        _response_queue.pop();
+        sent_responses++;
+    }
+
+    _stats.tx_packets += sent_responses;
+
+    if (_response_queue.empty()) {
+        set_epollout(false);
+    }
+
+    if (sent_responses > 0) {
+        _logger->debug("Sent " + std::to_string(sent_responses) + " responses");
+    }
+}
+
+void udp_reactor::send_pending_responses_batched() {
+    int32_t sent_responses = 0;
+
+    while (not _response_queue.empty()) {
+        uint32_t count = std::min<size_t>(_response_queue.size(), _batch_size);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto &resp = _response_queue[i];
+
+            _tx_iovecs[i] = {const_cast<char *>(resp.data.data()), resp.data.size()};
+            _tx_msgs[i].msg_hdr.msg_name = &resp.client_addr;
+            _tx_msgs[i].msg_hdr.msg_namelen = sizeof(resp.client_addr);
+        }
+
+        int sent = sendmmsg(_socket_fd, _tx_msgs.data(), count, MSG_DONTWAIT);
+        _stats.tx_syscalls++;
+
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            _logger->error("sendmmsg error: " + std::string(strerror(errno)));
+            _response_queue.pop();
+            continue;
+        }
+
+        for (int i = 0; i < sent; ++i) {
+            _response_queue.pop();
+        }
+        sent_responses += sent;
+
+        if (static_cast<uint32_t>(sent) < count) {
+            break;
+        }
+    }
+
+    _stats.tx_packets += sent_responses;
+
+    if (_response_queue.empty()) {
+        set_epollout(false);
+    }
+
+    if (sent_responses > 0) {
+        _logger->debug("Sent " + std::to_string(sent_responses) + " responses");
+    }
+}
+
+void udp_reactor::flush_responses() {
+    if (_batch_size > 1) {
+        send_pending_responses_batched();
+    } else {
+        send_pending_responses();
+    }
+}
+
+int32_t udp_reactor::process_requests() {
+    int32_t processed_requests = 0;
+    bool out_of_time = false;
+    auto started_at = std::chrono::steady_clock::now();
+    auto deadline = started_at + _time_budget;
+
+    while (not _request_queue.empty() && not _response_queue.full() &&
+           static_cast<uint32_t>(processed_requests) < _packet_budget) {
+        pending_request req = _request_queue.front();
+        _request_queue.pop();
+
+        auto request = _packet_pool.data(req.slot, req.offset, req.size);
+
+        // A retransmit within the TTL gets the original reply without touching sessions or emitting CDRs.
+        std::optional<packet_result> cached;
+        if (_response_cache) {
+            cached = _response_cache->find(req.client_addr, request, started_at);
+        }
+
+        udp_response::result result;
+        if (cached.has_value()) {
+            result = cached.value();
+            _stats.replayed_responses++;
+        } else {
+            result = _packet_manager->handle_packet(request);
+            if (_response_cache && result.has_value()) {
+                _response_cache->insert(req.client_addr, request, result.value(), started_at);
+            }
+        }
+        release_slot(req.slot);
+
+        (void) _response_queue.push({udp_response::encode(result), req.client_addr});
+
+        processed_requests++;
+
+        if (processed_requests % BUDGET_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) {
+            out_of_time = true;
+            break;
+        }
+    }
+
+    if (out_of_time) {
+        _packet_budget = std::max<uint32_t>(processed_requests, MIN_PACKET_BUDGET);
+    } else if (static_cast<uint32_t>(processed_requests) == _packet_budget && not _request_queue.empty()) {
+        _packet_budget = std::min<uint32_t>(_packet_budget * 2, _request_queue.capacity());
+    }
+
+    if (processed_requests > 0) {
+        _logger->debug("Processed " + std::to_string(processed_requests) + " requests");
+    }
+
+    return processed_requests;
+}
+
+void udp_reactor::release_slot(packet_pool::slot_id slot) {
+    if (_uring) {
+        _uring->provide_buffer(_packet_pool.buffer(slot).data(), SLOT_SIZE, static_cast<uint16_t>(slot));
+    } else {
+        _packet_pool.release(slot);
+    }
+}
+
+bool udp_reactor::setup_uring() {
+    _logger->debug("Setting up io_uring engine for UDP reactor " + std::to_string(_id));
+
+    uint32_t buffers = std::bit_floor(std::min<size_t>(_packet_pool.available(), 32768));
+
+    try {
+        _uring = std::make_unique<io_uring_ring>(URING_ENTRIES);
+        _uring->register_buffer_ring(URING_BUFFER_GROUP, buffers);
+    } catch (const io_uring_exception &e) {
+        _logger->warning("UDP reactor " + std::to_string(_id) +
+                         ": io_uring is not available, falling back to epoll: " + e.what());
+        _uring.reset();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < buffers; ++i) {
+        packet_pool::slot_id slot = _packet_pool.acquire();
+        _uring->provide_buffer(_packet_pool.buffer(slot).data(), SLOT_SIZE, static_cast<uint16_t>(slot));
+    }
+    _uring->commit_buffers();
+
+    _uring_recv_msg = {};
+    _uring_recv_msg.msg_namelen = sizeof(sockaddr_in);
+
+    _uring_sends.resize(URING_SEND_SLOTS);
+    _uring_free_sends.reserve(URING_SEND_SLOTS);
+    for (uint32_t i = URING_SEND_SLOTS; i > 0; --i) {
+        _uring_free_sends.push_back(i - 1);
+    }
+
+    arm_uring_recv();
+    arm_uring_stop();
+
+    _logger->info("UDP reactor " + std::to_string(_id) + " uses io_uring with " + std::to_string(buffers) +
+                  " provided receive buffers");
+    return true;
+}
+
+void udp_reactor::run_uring() {
+    while (_running.load()) {
+        int ret = _uring->submit_and_wait(1);
+        count_uring_enter();
+
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            _logger->error("io_uring_enter error: " + std::string(strerror(-ret)));
+            break;
+        }
+
+        _uring->for_each_cqe([this](const io_uring_cqe &cqe) { handle_uring_completion(cqe); });
+
+        process_requests();
+        _uring->commit_buffers();
+
+        if (_running.load() && not _uring_recv_armed) {
+            arm_uring_recv();
+        }
+
+        submit_uring_sends();
+        report_io_stats(false);
+    }
+
+    // Requests are processed only while the response queue has room, so replies go out in the same loop; sends in
+    // flight always complete, so waiting for one is progress. Nothing processed and nothing in flight means no send
+    // slot or SQE could be had, and there is nothing left to wait for.
+    _logger->info("Processing remaining requests and sending responses before shutdown...");
+    while (not _request_queue.empty() || not _response_queue.empty() ||
+           _uring_free_sends.size() < _uring_sends.size()) {
+        int32_t processed = process_requests();
+        submit_uring_sends();
+
+        if (processed == 0 && _uring_free_sends.size() == _uring_sends.size()) {
+            _logger->warning("UDP reactor " + std::to_string(_id) + " cannot send at shutdown, dropping " +
+                             std::to_string(_request_queue.size()) + " requests and " +
+                             std::to_string(_response_queue.size()) + " responses");
+            break;
+        }
+
+        int ret = _uring->submit_and_wait(1);
+        count_uring_enter();
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            _logger->error("io_uring_enter error: " + std::string(strerror(-ret)));
+            break;
+        }
+
+        _uring->for_each_cqe([this](const io_uring_cqe &cqe) { handle_uring_completion(cqe); });
+        _uring->commit_buffers();
+    }
+}
+
+void udp_reactor::arm_uring_recv() {
+    io_uring_sqe *sqe = _uring->get_sqe();
+    if (sqe == nullptr) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = _socket_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&_uring_recv_msg);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = static_cast<uint64_t>(uring_op::recv) << 32;
+
+    _uring_recv_armed = true;
+}
+
+void udp_reactor::arm_uring_stop() {
+    io_uring_sqe *sqe = _uring->get_sqe();
+    if (sqe == nullptr) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _stop_event_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = static_cast<uint64_t>(uring_op::stop) << 32;
+}
+
+void udp_reactor::cancel_uring_recv() {
+    io_uring_sqe *sqe = _uring->get_sqe();
+    if (sqe == nullptr) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = static_cast<uint64_t>(uring_op::recv) << 32;
+    sqe->user_data = static_cast<uint64_t>(uring_op::cancel) << 32;
+}
+
+// Sends are not linked: a reply that fails for its own destination (EHOSTUNREACH, EPERM from netfilter, EMSGSIZE)
+// would otherwise cancel every reply queued behind it in the chain.
+void udp_reactor::submit_uring_sends() {
+    while (not _response_queue.empty() && not _uring_free_sends.empty()) {
+        io_uring_sqe *sqe = _uring->get_sqe();
+        if (sqe == nullptr) {
+            break;
+        }
+
+        uint32_t index = _uring_free_sends.back();
+        _uring_free_sends.pop_back();
+
+        uring_send &send = _uring_sends[index];
+        send.response = _response_queue.front();
+        _response_queue.pop();
+
+        send.iov = {const_cast<char *>(send.response.data.data()), send.response.data.size()};
+        send.msg = {};
+        send.msg.msg_name = &send.response.client_addr;
+        send.msg.msg_namelen = sizeof(send.response.client_addr);
+        send.msg.msg_iov = &send.iov;
+        send.msg.msg_iovlen = 1;
+
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = _socket_fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&send.msg);
+        sqe->len = 1;
+        sqe->user_data = (static_cast<uint64_t>(uring_op::send) << 32) | index;
+        _uring_sends_queued = true;
+    }
+}
+
+// Every io_uring_enter waits for receives; one that also submits prepared sends counts on the transmit side too, so
+// packets per syscall compare with epoll's recvmmsg/sendmmsg figures. Such an enter counts twice in syscalls/s.
+void udp_reactor::count_uring_enter() {
+    _stats.rx_syscalls++;
+    if (_uring_sends_queued) {
+        _stats.tx_syscalls++;
+        _uring_sends_queued = false;
+    }
+}
+
+void udp_reactor::handle_uring_completion(const io_uring_cqe &cqe) {
+    auto op = static_cast<uring_op>(cqe.user_data >> 32);
+    auto index = static_cast<uint32_t>(cqe.user_data);
+
+    switch (op) {
+        case uring_op::recv:
+            handle_uring_recv(cqe);
+            break;
+
+        case uring_op::stop: {
+            _logger->info("Received stop signal");
+            _running.store(false);
+
+            uint64_t val;
+            if (eventfd_read(_stop_event_fd, &val) < 0) {
+                _logger->error("Failed to read from stop event fd: " + std::string(strerror(errno)));
+            }
+
+            cancel_uring_recv();
+            break;
+        }
+
+        case uring_op::cancel:
+            break;
+
+        case uring_op::send:
+            if (cqe.res < 0) {
+                _logger->error("sendmsg error: " + std::string(strerror(-cqe.res)));
+            } else {
+                _stats.tx_packets++;
+            }
+            _uring_free_sends.push_back(index);
+            break;
+    }
+}
+
+void udp_reactor::handle_uring_recv(const io_uring_cqe &cqe) {
+    if (not(cqe.flags & IORING_CQE_F_MORE)) {
+        _uring_recv_armed = false;
+    }
+
+    if (cqe.res < 0) {
+        if (cqe.res == -ENOBUFS) {
+            _logger->debug("Receive buffer ring exhausted, deferring reads");
+        } else if (cqe.res == -EINVAL) {
+            _logger->fatal("Kernel rejected multishot recvmsg, stopping UDP reactor " + std::to_string(_id));
+            _running.store(false);
+        } else if (cqe.res != -ECANCELED) {
+            _logger->error("recvmsg error: " + std::string(strerror(-cqe.res)));
+        }
+        return;
+    }
+
+    if (not(cqe.flags & IORING_CQE_F_BUFFER)) {
+        return;
+    }
+
+    auto slot = static_cast<packet_pool::slot_id>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+    if (not _running.load()) {
+        release_slot(slot);
+        return;
+    }
+
+    std::span<uint8_t> buffer = _packet_pool.buffer(slot);
+
+    io_uring_recvmsg_out out;
+    std::memcpy(&out, buffer.data(), sizeof(out));
+
+    if ((out.flags & MSG_TRUNC) || out.namelen > sizeof(sockaddr_in)) {
+        _logger->error("Received packet larger than buffer, dropping");
+        release_slot(slot);
+        return;
+    }
+
+    if (out.payloadlen == 0) {
+        _logger->debug("Received empty packet, ignoring");
+        release_slot(slot);
+        return;
+    }
+
+    sockaddr_in client_addr;
+    std::memcpy(&client_addr, buffer.data() + sizeof(out), sizeof(client_addr));
+
+    (void) _request_queue.push({slot, RECVMSG_HEADER_SIZE, static_cast<uint16_t>(out.payloadlen), client_addr});
+    _stats.rx_packets++;
+}
+
+void udp_reactor::report_io_stats(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = now - _reported_at;
+
+    if (not force && elapsed < STATS_INTERVAL) {
+        return;
+    }
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    uint64_t rx_syscalls = _stats.rx_syscalls - _reported_stats.rx_syscalls;
+    uint64_t rx_packets = _stats.rx_packets - _reported_stats.rx_packets;
+    uint64_t tx_syscalls = _stats.tx_syscalls - _reported_stats.tx_syscalls;
+    uint64_t tx_packets = _stats.tx_packets - _reported_stats.tx_packets;
+    uint64_t epoll_ctl_calls = _stats.epoll_ctl_calls - _reported_stats.epoll_ctl_calls;
+
+    update_socket_drops();
+    uint64_t socket_drops = _stats.socket_drops - _reported_stats.socket_drops;
+    uint64_t replayed_responses = _stats.replayed_responses - _reported_stats.replayed_responses;
+
+    if (rx_syscalls + tx_syscalls + socket_drops > 0 && seconds > 0) {
+        _logger->info(std::format("UDP reactor {} I/O: rx {} packets / {} syscalls ({:.2f} per syscall), tx {} "
+                                  "packets / {} syscalls ({:.2f} per syscall), {:.0f} syscalls/s, {} epoll_ctl "
+                                  "calls, packet budget {}, {} packets dropped at the socket (filter rejects and "
+                                  "receive buffer overflows), {} retransmits replayed from cache",
+                                  _id, rx_packets, rx_syscalls, rx_syscalls ? double(rx_packets) / rx_syscalls : 0.0,
+                                  tx_packets, tx_syscalls, tx_syscalls ? double(tx_packets) / tx_syscalls : 0.0,
+                                  (rx_syscalls + tx_syscalls) / seconds, epoll_ctl_calls, _packet_budget, socket_drops,
+                                  replayed_responses));
+    }
+
+    _reported_stats = _stats;
+    _reported_at = now;
+}
+
+void udp_reactor::update_socket_drops() {
+    // sk_drops counts socket filter rejects and receive buffer overflows together, and the kernel keeps no per-socket
+    // split of the two, hence socket_drops rather than a filter counter. It is a wrapping 32-bit counter.
+    std::array<uint32_t, SK_MEMINFO_VARS> meminfo{};
+    socklen_t len = sizeof(meminfo);
+    if (getsockopt(_socket_fd, SOL_SOCKET, SO_MEMINFO, meminfo.data(), &len) < 0) {
+        return;
+    }
+
+    uint32_t drops = meminfo[SK_MEMINFO_DROPS];
+    _stats.socket_drops += static_cast<uint32_t>(drops - static_cast<uint32_t>(_stats.socket_drops));
+}
+
+void udp_reactor::set_epollout(bool enabled) {
+    if (_epollout_enabled == enabled) {
+        return;
+    }
+
+    epoll_event event;
+    event.events = enabled ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.fd = _socket_fd;
+    epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, _socket_fd, &event);
+
+    _epollout_enabled = enabled;
+    _stats.epoll_ctl_calls++;
+    _logger->debug(enabled ? "Enabled EPOLLOUT on socket" : "Disabled EPOLLOUT, now only monitoring EPOLLIN on socket");
+}
+
+void udp_reactor::stop() {
+    _logger->info("Stopping UDP reactor " + std::to_string(_id) + "...");
+    _running.store(false);
+
+    uint64_t val = 1;
+    if (eventfd_write(_stop_event_fd, val) < 0) {
+        _logger->error("Failed to write to stop event fd: " + std::string(strerror(errno)));
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <vector>
+
+#include <bounded_queue.hpp>
+#include <packet_pool.hpp>
+
+class config;
+class packet_manager;
+class logger;
+class io_uring_ring;
+class response_cache;
+struct io_uring_cqe;
+
+enum class io_engine { epoll, io_uring };
+
+class udp_reactor {
+public:
+    udp_reactor(std::shared_ptr<config> config, std::shared_ptr<packet_manager> packet_manager,
+                std::shared_ptr<logger> logger, uint32_t id, bool reuse_port);
+    ~udp_reactor();
+
+    udp_reactor(const udp_reactor &) = delete;
+    udp_reactor &operator=(const udp_reactor &) = delete;
+    udp_reactor(udp_reactor &&) = delete;
+    udp_reactor &operator=(udp_reactor &&) = delete;
+
+    void run();
+    void stop();
+
+    // Steers datagrams of the whole SO_REUSEPORT group by IMSI so a subscriber always lands on the same reactor.
+    [[nodiscard]] bool attach_steering_program(uint32_t reactors_num);
+
+private:
+    static constexpr u_int16_t MAX_EVENTS = 64;
+    static constexpr u_int16_t BUFFER_SIZE = 1024;
+    static constexpr u_int16_t RECVMSG_HEADER_SIZE = 16 + sizeof(sockaddr_in);
+    static constexpr u_int16_t SLOT_SIZE = BUFFER_SIZE + RECVMSG_HEADER_SIZE;
+    static constexpr uint32_t MIN_PACKET_BUDGET = 16;
+    static constexpr uint32_t BUDGET_CHECK_INTERVAL = 8;
+    static constexpr uint32_t DEFAULT_TIME_BUDGET_US = 200;
+    static constexpr uint32_t DEFAULT_BUFFER_POOL_SIZE = 4096;
+    static constexpr uint32_t DEFAULT_RETRANSMIT_CACHE_SIZE = 4096;
+    static constexpr uint32_t DEFAULT_RETRANSMIT_TTL_MS = 2000;
+    static constexpr std::chrono::seconds STATS_INTERVAL{10};
+    static constexpr int SHUTDOWN_SEND_TIMEOUT_MS = 1000;
+    static constexpr uint32_t URING_ENTRIES = 256;
+    static constexpr uint32_t URING_SEND_SLOTS = 128;
+    static constexpr uint16_t URING_BUFFER_GROUP = 0;
+
+private:
+    struct pending_request {
+        packet_pool::slot_id slot;
+        uint16_t offset;
+        uint16_t size;
+        sockaddr_in client_addr;
+    };
+
+    struct pending_response {
+        std::string_view data;
+        sockaddr_in client_addr;
+    };
+
+    struct io_stats {
+        uint64_t rx_syscalls = 0;
+        uint64_t rx_packets = 0;
+        uint64_t tx_syscalls = 0;
+        uint64_t tx_packets = 0;
+        uint64_t epoll_ctl_calls = 0;
+        uint64_t socket_drops = 0;
+        uint64_t replayed_responses = 0;
+    };
+
+    enum class uring_op : uint64_t { recv = 1, stop, cancel, send };
+
+    struct uring_send {
+        msghdr msg;
+        iovec iov;
+        pending_response response;
+    };
+
+private:
+    void init_setup(const std::string &ip, int port, bool reuse_port);
+    void attach_packet_filter();
+    void enable_socket_busy_poll();
+    void setup_stop_event();
+    void setup_batch_buffers();
+
+    void run_epoll();
+    bool spin_receive();
+    void receive_packets();
+    void read_packets();
+    void read_packets_batched();
+    void send_pending_responses();
+    void send_pending_responses_batched();
+    void flush_responses();
+    int32_t process_requests();
+    void release_slot(packet_pool::slot_id slot);
+
+    bool setup_uring();
+    void run_uring();
+    void arm_uring_recv();
+    void arm_uring_stop();
+    void cancel_uring_recv();
+    void submit_uring_sends();
+    void count_uring_enter();
+    void handle_uring_completion(const io_uring_cqe &cqe);
+    void handle_uring_recv(const io_uring_cqe &cqe);
+
+    void report_io_stats(bool force);
+    void update_socket_drops();
+
+    void set_epollout(bool enabled);
+
+private:
+    std::shared_ptr<config> _config;
+    std::shared_ptr<packet_manager> _packet_manager;
+    std::shared_ptr<logger> _logger;
+
+    uint32_t _id;
+    int _socket_fd;
+    int _epoll_fd;
+    int _stop_event_fd;
+
+    packet_pool _packet_pool;
+    bounded_queue<pending_request> _request_queue;
+    bounded_queue<pending_response> _response_queue;
+    std::unique_ptr<response_cache> _response_cache;
+
+    uint32_t _batch_size;
+    bool _inline_responses;
+    bool _kernel_filter;
+    bool _epollout_enabled;
+    std::chrono::microseconds _time_budget;
+    std::chrono::microseconds _busy_poll_window;
+    uint32_t _packet_budget;
+    std::vector<packet_pool::slot_id> _rx_slots;
+    std::vector<sockaddr_in> _rx_addrs;
+    std::vector<iovec> _rx_iovecs;
+    std::vector<mmsghdr> _rx_msgs;
+    std::vector<iovec> _tx_iovecs;
+    std::vector<mmsghdr> _tx_msgs;
+
+    io_engine _engine;
+    std::unique_ptr<io_uring_ring> _uring;
+    msghdr _uring_recv_msg;
+    bool _uring_recv_armed;
+    // Sends prepared since the last io_uring_enter, which will carry them.
+    bool _uring_sends_queued;
+    std::vector<uring_send> _uring_sends;
+    std::vector<uint32_t> _uring_free_sends;
+
+    io_stats _stats;
+    io_stats _reported_stats;
+    std::chrono::steady_clock::time_point _reported_at;
+
+    std::atomic<bool> _running{false};
+};
@@ -0,0 +1,34 @@
+#include <array>
+#include <format>
+#include <string>
+
+#include <udp_response.hpp>
+
+#include <magic_enum/magic_enum.hpp>
+
+namespace udp_response {
+
+    namespace {
+        const auto &error_responses() {
+            static const auto responses = [] {
+                std::array<std::string, magic_enum::enum_count<packet_manager_error>()> table;
+                for (auto error: magic_enum::enum_values<packet_manager_error>()) {
+                    table[magic_enum::enum_index(error).value()] =
+                            std::format("Error: {}", magic_enum::enum_name(error));
+                }
+                return table;
+            }();
+
+            return responses;
+        }
+    } // namespace
+
+    std::string_view encode(const result &result) {
+        if (result.has_value()) {
+            return magic_enum::enum_name(result.value());
+        }
+
+        return error_responses()[magic_enum::enum_index(result.error()).value()];
+    }
+
+} // namespace udp_response
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <expected>
+#include <string_view>
+
+#include <packet_manager.hpp>
+
+namespace udp_response {
+    using result = std::expected<packet_result, packet_manager_error>;
+
+    [[nodiscard]] std::string_view encode(const result &result);
+} // namespace udp_response
@@ -1,20 +1,16 @@
 #pragma once
 
-#include <arpa/inet.h>
-#include <array>
-#include <atomic>
 #include <memory>
-#include <queue>
-#include <span>
 #include <stdexcept>
 #include <string>
-#include <sys/epoll.h>
+#include <thread>
+#include <vector>
 
 class config;
 class packet_manager;
 class logger;
 class event_bus;
-class thread_pool;
+class udp_reactor;
 
 class udp_server_exception : public std::runtime_error {
 public:
@@ -23,7 +19,6 @@ public:
 };
 
 class udp_server {
-private:
 public:
     udp_server(std::shared_ptr<config> config, std::shared_ptr<packet_manager> packet_manager,
                std::shared_ptr<logger> logger, std::shared_ptr<event_bus> event_bus);
@@ -38,44 +33,15 @@ public:
     void stop();
 
 private:
-    static constexpr u_int16_t MAX_EVENTS = 64;
-    static constexpr u_int16_t BUFFER_SIZE = 1024;
-    static constexpr u_int16_t MAX_BATCH = 10;
-
-private:
-    struct pending_request {
-        std::span<const uint8_t> data;
-        sockaddr_in client_addr;
-    };
-
-    struct pending_response {
-        std::string data;
-        sockaddr_in client_addr;
-    };
-
-private:
-    void init_setup(const std::string &ip, int port);
-    void setup_stop_event();
+    void setup_reactors();
     void setup_event_handlers();
 
-    void read_packets(std::array<uint8_t, BUFFER_SIZE> &buffer);
-    void send_pending_responses();
-    void process_requests();
-
-    void modify_epoll_events(uint32_t events);
-
 private:
     std::shared_ptr<config> _config;
     std::shared_ptr<packet_manager> _packet_manager;
     std::shared_ptr<logger> _logger;
     std::shared_ptr<event_bus> _event_bus;
 
-    int _socket_fd;
-    int _epoll_fd;
-    int _stop_event_fd;
-
-    std::queue<pending_request> _request_queue;
-    std::queue<pending_response> _response_queue;
-
-    std::atomic<bool> _running{false};
+    std::vector<std::unique_ptr<udp_reactor>> _reactors;
+    std::vector<std::jthread> _reactor_threads;
 };
@@ -0,0 +1,157 @@
+#include <arpa/inet.h>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bounded_queue.hpp>
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <packet_manager.hpp>
+#include <session_manager.hpp>
+#include <thread_pool.hpp>
+#include <udp_response.hpp>
+#include <utility.hpp>
+
+namespace {
+    // Per thread, so that the session manager's and the pool's own threads do not count against the loop under test.
+    // Replacing operator new affects the whole binary, which is why these tests have an executable of their own.
+    thread_local size_t allocations = 0;
+} // namespace
+
+[[gnu::noinline]] void *operator new(std::size_t size) {
+    allocations++;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line so GCC does not pair the inlined malloc/free with the replaced operators.
+[[gnu::noinline]] void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+TEST(AllocationTest, SteadyStateDoesNotAllocate) {
+    bounded_queue<std::string_view> queue(64);
+
+    // Warm up the static error table before counting.
+    (void) udp_response::encode(std::unexpected(packet_manager_error::packet_parsing_failed));
+
+    const size_t before = allocations;
+
+    for (int i = 0; i < 10000; ++i) {
+        const udp_response::result result =
+                i % 3 == 0 ? udp_response::result(std::unexpected(packet_manager_error::packet_parsing_failed))
+                           : udp_response::result(i % 3 == 1 ? packet_result::created : packet_result::rejected);
+
+        ASSERT_TRUE(queue.push(udp_response::encode(result)));
+        if (queue.full()) {
+            while (not queue.empty()) {
+                queue.pop();
+            }
+        }
+    }
+
+    EXPECT_EQ(allocations, before);
+}
+
+// The reactor's request path past the socket: packet_manager::handle_packet on a received datagram, encode, and the
+// reply queued as the reactor queues it (pending_response is private to udp_reactor; same shape here). Logging is at
+// the shipped default, info, and every outcome is exercised: created, blacklisted, already existing, malformed.
+// Sessions are preallocated with max_sessions; without it the session table grows, and allocates, as it fills. The
+// bus has no subscribers, so the CDR path is not covered.
+TEST(AllocationTest, RequestPathDoesNotAllocate) {
+    constexpr size_t sessions_num = 4096;
+
+    struct pending_response {
+        std::string_view data;
+        sockaddr_in client_addr;
+    };
+
+    auto dir = std::filesystem::temp_directory_path();
+    auto config_path = dir / "test_udp_response_config.json";
+    std::ofstream(config_path) << R"({
+        "server_ip": "127.0.0.1",
+        "server_port": 0,
+        "session_timeout_sec": 3600,
+        "cdr_file": ")" << (dir / "test_udp_response_cdr.log").string()
+                               << R"(",
+        "http_port": 0,
+        "graceful_shutdown_rate": 1000,
+        "log_file": ")" << (dir / "test_udp_response.log").string()
+                               << R"(",
+        "log_level": "info",
+        "max_sessions": )" << sessions_num
+                               << R"(,
+        "blacklist": ["001010000000001"]
+    })";
+
+    auto cfg = std::make_shared<config>(config_path);
+    auto log = std::make_shared<logger>(cfg);
+    auto pool = std::make_shared<thread_pool>(1, log);
+    auto bus = std::make_shared<event_bus>(pool, log);
+    auto sessions = std::make_shared<session_manager>(cfg, bus, log);
+    packet_manager manager(cfg, bus, sessions, log);
+
+    // Datagrams as they sit in the packet pool. Of every eight: one blacklisted, one malformed, five fresh
+    // subscribers and a retry of the last of them.
+    std::vector<std::vector<uint8_t>> packets;
+    auto blacklisted = utility::encode_imsi_to_bcd("001010000000001").value();
+    std::vector<uint8_t> malformed{0xff};
+    for (size_t i = 0; i < sessions_num; ++i) {
+        switch (i % 8) {
+            case 0:
+                packets.push_back(blacklisted);
+                break;
+            case 1:
+                packets.push_back(malformed);
+                break;
+            case 7:
+                packets.push_back(packets.back());
+                break;
+            default:
+                packets.push_back(utility::encode_imsi_to_bcd("00101" + std::to_string(1000000000 + i)).value());
+        }
+    }
+
+    bounded_queue<pending_response> queue(64);
+    sockaddr_in client{};
+    client.sin_family = AF_INET;
+
+    (void) udp_response::encode(std::unexpected(packet_manager_error::packet_parsing_failed));
+
+    const size_t before = allocations;
+
+    size_t created = 0;
+    size_t rejected = 0;
+    size_t failed = 0;
+    for (const auto &packet: packets) {
+        auto result = manager.handle_packet(packet);
+        created += result == packet_result::created ? 1 : 0;
+        rejected += result == packet_result::rejected ? 1 : 0;
+        failed += result.has_value() ? 0 : 1;
+
+        ASSERT_TRUE(queue.push({udp_response::encode(result), client}));
+        if (queue.full()) {
+            while (not queue.empty()) {
+                queue.pop();
+            }
+        }
+    }
+
+    EXPECT_EQ(allocations, before);
+    EXPECT_EQ(created, sessions_num / 8 * 5);
+    EXPECT_EQ(rejected, sessions_num / 8 * 2);
+    EXPECT_EQ(failed, sessions_num / 8);
+
+    std::filesystem::remove(config_path);
+}
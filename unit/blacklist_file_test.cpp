@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <blacklist_file.hpp>
+
+class BlacklistFileTest : public ::testing::Test {
+protected:
+    void SetUp() override { path = std::filesystem::temp_directory_path() / "test_blacklist.txt"; }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    void WriteFile(const std::string &content) { std::ofstream(path, std::ios::binary) << content; }
+
+    static packed_imsi imsi(uint64_t n) {
+        return packed_imsi::from_string("00101" + std::to_string(1000000000 + n)).value();
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(BlacklistFileTest, SkipsBlankCommentAndInvalidLines) {
+    WriteFile("# subscribers barred by the operator\n"
+              "001011000000003\n"
+              "\n"
+              "  001011000000001\r\n"
+              "00101100000000X\n"
+              "0010110000000011234\n"
+              "001011000000003\n"
+              "001011000000002");
+
+    auto contents = read_blacklist_file(path, 1);
+
+    EXPECT_EQ(contents.imsis, (std::vector<packed_imsi>{imsi(1), imsi(2), imsi(3)}));
+    EXPECT_EQ(contents.invalid_lines, 2u);
+}
+
+TEST_F(BlacklistFileTest, EmptyFile) {
+    WriteFile("");
+
+    auto contents = read_blacklist_file(path, 4);
+
+    EXPECT_TRUE(contents.imsis.empty());
+    EXPECT_EQ(contents.invalid_lines, 0u);
+}
+
+TEST_F(BlacklistFileTest, MissingFileThrows) {
+    EXPECT_THROW((void) read_blacklist_file("/nonexistent/blacklist.txt", 1), blacklist_file_exception);
+}
+
+TEST_F(BlacklistFileTest, ChunkedParseMatchesSingleThread) {
+    // Several megabytes, so the file splits into chunks; duplicates land in different chunks.
+    std::mt19937_64 rng(11);
+    std::vector<packed_imsi> expected;
+    std::string content;
+    for (size_t i = 0; i < 400'000; ++i) {
+        packed_imsi entry = imsi(rng() % 300'000);
+        expected.push_back(entry);
+        content += entry.to_string() + "\n";
+    }
+    WriteFile(content);
+
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    EXPECT_EQ(read_blacklist_file(path, 1).imsis, expected);
+    EXPECT_EQ(read_blacklist_file(path, 3).imsis, expected);
+    EXPECT_EQ(read_blacklist_file(path, 8).imsis, expected);
+}
+
+TEST_F(BlacklistFileTest, MergesConfigIntoFileList) {
+    // Config entries arrive unsorted and fall between, before, after and on top of the file's.
+    std::vector<packed_imsi> imsis{imsi(9), imsi(4), imsi(0), imsi(6), imsi(4)};
+    std::vector<packed_imsi> file{imsi(1), imsi(3), imsi(4), imsi(5), imsi(7)};
+
+    merge_blacklists(imsis, file);
+
+    EXPECT_EQ(imsis, (std::vector<packed_imsi>{imsi(0), imsi(1), imsi(3), imsi(4), imsi(5), imsi(6), imsi(7),
+                                               imsi(9)}));
+}
+
+TEST_F(BlacklistFileTest, MergesWithEitherSideEmpty) {
+    std::vector<packed_imsi> imsis;
+    merge_blacklists(imsis, {imsi(1), imsi(2)});
+    EXPECT_EQ(imsis, (std::vector<packed_imsi>{imsi(1), imsi(2)}));
+
+    merge_blacklists(imsis, {});
+    EXPECT_EQ(imsis, (std::vector<packed_imsi>{imsi(1), imsi(2)}));
+}
@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <blacklist.hpp>
+
+class BlacklistTest : public ::testing::Test {
+protected:
+    static packed_imsi imsi(uint64_t n) {
+        return packed_imsi::from_string("00101" + std::to_string(1000000000 + n)).value();
+    }
+};
+
+TEST_F(BlacklistTest, EmptyContainsNothing) {
+    blacklist empty;
+    EXPECT_FALSE(empty.contains(imsi(1)));
+    EXPECT_TRUE(empty.empty());
+
+    blacklist built(std::vector<packed_imsi>{});
+    EXPECT_FALSE(built.contains(imsi(1)));
+    EXPECT_EQ(built.memory_usage(), 0u);
+}
+
+TEST_F(BlacklistTest, FindsEveryEntryAndDropsDuplicates) {
+    blacklist list({imsi(5), imsi(1), imsi(3), imsi(1)});
+
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_TRUE(list.contains(imsi(1)));
+    EXPECT_TRUE(list.contains(imsi(3)));
+    EXPECT_TRUE(list.contains(imsi(5)));
+    EXPECT_FALSE(list.contains(imsi(0)));
+    EXPECT_FALSE(list.contains(imsi(2)));
+    EXPECT_FALSE(list.contains(imsi(6)));
+}
+
+TEST_F(BlacklistTest, ExactForEveryTreeSize) {
+    for (uint64_t n = 1; n <= 70; ++n) {
+        std::vector<packed_imsi> imsis;
+        for (uint64_t i = 0; i < n; ++i) {
+            imsis.push_back(imsi(i * 2));
+        }
+        blacklist list(imsis);
+
+        for (uint64_t i = 0; i < 2 * n + 2; ++i) {
+            EXPECT_EQ(list.contains(imsi(i)), i % 2 == 0 && i < 2 * n) << "n=" << n << " i=" << i;
+        }
+    }
+}
+
+TEST_F(BlacklistTest, LargeListStaysCompact) {
+    constexpr uint64_t count = 1'000'000;
+
+    std::vector<packed_imsi> imsis;
+    imsis.reserve(count);
+    std::mt19937_64 rng(7);
+    for (uint64_t i = 0; i < count; ++i) {
+        imsis.push_back(imsi(rng() % 100'000'000));
+    }
+    blacklist list(imsis);
+
+    for (size_t i = 0; i < imsis.size(); i += 97) {
+        EXPECT_TRUE(list.contains(imsis[i]));
+    }
+    EXPECT_LT(list.memory_usage(), list.size() * 12);
+}
+
+TEST_F(BlacklistTest, EntriesComeBackSorted) {
+    blacklist list({imsi(9), imsi(2), imsi(7), imsi(2), imsi(4)});
+
+    EXPECT_EQ(list.entries(), (std::vector<packed_imsi>{imsi(2), imsi(4), imsi(7), imsi(9)}));
+    EXPECT_TRUE(blacklist().entries().empty());
+}
@@ -33,24 +33,35 @@ TEST_F(ConfigTest, ValidConfig) {
         "graceful_shutdown_rate": 10,
         "log_file": "/tmp/server.log",
         "log_level": "info",
-        "blacklist": ["123456", "789012"]
+        "blacklist": ["123456", "789012"],
+        "blacklist_file": "/tmp/blacklist.txt",
+        "session_state_file": "/tmp/sessions.bin",
+        "max_sessions": 1000000,
+        "session_huge_pages": true,
+        "udp_batch_size": 16
     })");
 
     config cfg(test_config_path);
 
     EXPECT_EQ(cfg.get_ip().value(), "127.0.0.1");
-    EXPECT_EQ(cfg.get_port().value(), 8080);
-    EXPECT_EQ(cfg.get_http_port().value(), 8081);
-    EXPECT_EQ(cfg.get_session_timeout_sec().value(), 300);
+    EXPECT_EQ(cfg.get_port().value(), 8080u);
+    EXPECT_EQ(cfg.get_http_port().value(), 8081u);
+    EXPECT_EQ(cfg.get_session_timeout_sec().value(), 300u);
     EXPECT_EQ(cfg.get_cdr_file().value(), "/tmp/cdr.log");
-    EXPECT_EQ(cfg.get_graceful_shutdown_rate().value(), 10);
+    EXPECT_EQ(cfg.get_graceful_shutdown_rate().value(), 10u);
     EXPECT_EQ(cfg.get_log_file().value(), "/tmp/server.log");
     EXPECT_EQ(cfg.get_log_level().value(), "info");
+    EXPECT_EQ(cfg.get_udp_batch_size().value(), 16u);
 
     auto blacklist = cfg.get_blacklist().value();
-    EXPECT_EQ(blacklist.size(), 2);
+    EXPECT_EQ(blacklist.size(), 2u);
     EXPECT_TRUE(blacklist.contains("123456"));
     EXPECT_TRUE(blacklist.contains("789012"));
+    EXPECT_EQ(cfg.get_blacklist_file().value(), "/tmp/blacklist.txt");
+    EXPECT_EQ(cfg.get_session_state_file().value(), "/tmp/sessions.bin");
+    EXPECT_EQ(cfg.get_max_sessions().value(), 1000000u);
+    EXPECT_TRUE(cfg.get_session_huge_pages().value());
+    EXPECT_FALSE(cfg.get_session_prefault().has_value());
 }
 
 TEST_F(ConfigTest, PartialConfig) {
@@ -65,6 +76,10 @@ TEST_F(ConfigTest, PartialConfig) {
     EXPECT_TRUE(cfg.get_port().has_value());
     EXPECT_FALSE(cfg.get_http_port().has_value());
     EXPECT_FALSE(cfg.get_session_timeout_sec().has_value());
+    EXPECT_FALSE(cfg.get_udp_batch_size().has_value());
+    EXPECT_FALSE(cfg.get_blacklist_file().has_value());
+    EXPECT_FALSE(cfg.get_session_state_file().has_value());
+    EXPECT_FALSE(cfg.get_max_sessions().has_value());
 }
 
 TEST_F(ConfigTest, NullValues) {
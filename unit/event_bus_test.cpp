@@ -0,0 +1,313 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <config.hpp>
+#include <event_bus.hpp>
+#include <logger.hpp>
+#include <thread_pool.hpp>
+
+class EventBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto dir = std::filesystem::temp_directory_path();
+        config_path = dir / "test_event_bus_config.json";
+        std::ofstream(config_path) << R"({"log_file": ")" << (dir / "test_event_bus.log").string()
+                                   << R"(", "log_level": "error"})";
+
+        log = std::make_shared<logger>(std::make_shared<config>(config_path));
+        pool = std::make_shared<thread_pool>(2, log);
+        bus = std::make_unique<event_bus>(pool, log);
+    }
+
+    void TearDown() override {
+        bus.reset();
+        pool.reset();
+        std::filesystem::remove(config_path);
+    }
+
+    template<typename Predicate>
+    static bool eventually(Predicate done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (not done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::filesystem::path config_path;
+    std::shared_ptr<logger> log;
+    std::shared_ptr<thread_pool> pool;
+    std::unique_ptr<event_bus> bus;
+};
+
+TEST_F(EventBusTest, DeliversToEverySubscriberOfThatEventOnly) {
+    auto imsi = packed_imsi::from_string("001010123456789").value();
+
+    std::atomic<int> created{0};
+    std::atomic<int> rejected{0};
+    std::atomic<uint64_t> seen{0};
+
+    // Same parameters as reject_session_event, but a list of its own.
+    bus->subscribe<events::create_session_event>([&](packed_imsi value) {
+        seen.store(value.packed());
+        created.fetch_add(1);
+    });
+    bus->subscribe<events::create_session_event>([&](packed_imsi) { created.fetch_add(1); });
+    bus->subscribe<events::reject_session_event>([&](packed_imsi) { rejected.fetch_add(1); });
+
+    bus->publish<events::create_session_event>(imsi);
+
+    EXPECT_TRUE(eventually([&] { return created.load() == 2; }));
+    EXPECT_EQ(seen.load(), imsi.packed());
+    EXPECT_EQ(rejected.load(), 0);
+}
+
+TEST_F(EventBusTest, CarriesBatchesAndEmptyPayloads) {
+    std::atomic<size_t> batch{0};
+    std::atomic<bool> shutdown{false};
+
+    bus->subscribe<events::delete_sessions_event>(
+            [&](const std::vector<packed_imsi> &imsis) { batch.store(imsis.size()); });
+    bus->subscribe<events::graceful_shutdown_event>([&]() { shutdown.store(true); });
+
+    std::vector<packed_imsi> imsis(3, packed_imsi::from_string("001010123456789").value());
+    bus->publish<events::delete_sessions_event>(std::move(imsis));
+    bus->publish<events::graceful_shutdown_event>();
+    // Nobody listens; nothing to deliver.
+    bus->publish<events::create_session_event>(packed_imsi::from_string("001010123456789").value());
+
+    EXPECT_TRUE(eventually([&] { return batch.load() == 3 && shutdown.load(); }));
+}
+
+TEST_F(EventBusTest, BatchesFillUpToTheThresholdAndFlushTheRest) {
+    std::mutex mutex;
+    std::vector<std::vector<packed_imsi>> batches;
+
+    bus->subscribe_batch<events::create_session_event>(
+            [&](std::span<const packed_imsi> imsis) {
+                std::lock_guard<std::mutex> lock(mutex);
+                batches.emplace_back(imsis.begin(), imsis.end());
+            },
+            {.max_events = 4, .max_delay = std::chrono::hours(1)});
+
+    for (uint64_t i = 0; i < 10; ++i) {
+        bus->publish<events::create_session_event>(packed_imsi::from_string("00101" + std::to_string(i)).value());
+    }
+
+    EXPECT_TRUE(eventually([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches.size() == 2;
+    }));
+
+    bus->flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(batches[0].size() + batches[1].size(), 8u);
+    EXPECT_EQ(batches[2].size(), 2u);
+}
+
+TEST_F(EventBusTest, PartialBatchGoesOutAfterTheDelay) {
+    std::atomic<size_t> delivered{0};
+    std::atomic<size_t> deliveries{0};
+
+    bus->subscribe_batch<events::reject_session_event>(
+            [&](std::span<const packed_imsi> imsis) {
+                delivered.fetch_add(imsis.size());
+                deliveries.fetch_add(1);
+            },
+            {.max_events = 1000, .max_delay = std::chrono::milliseconds(20)});
+
+    for (int i = 0; i < 3; ++i) {
+        bus->publish<events::reject_session_event>(packed_imsi::from_string("001010123456789").value());
+    }
+
+    EXPECT_TRUE(eventually([&] { return delivered.load() == 3; }));
+    EXPECT_EQ(deliveries.load(), 1u);
+}
+
+TEST_F(EventBusTest, UnsubscribeHandsOverBufferedEventsAndOutlastsQueuedDeliveries) {
+    std::atomic<size_t> batched{0};
+    std::atomic<int> handled{0};
+
+    auto batch = bus->subscribe_batch<events::reject_session_event>(
+            [&](std::span<const packed_imsi> imsis) { batched.fetch_add(imsis.size()); },
+            {.max_events = 1000, .max_delay = std::chrono::hours(1)});
+    auto handler = bus->subscribe<events::create_session_event>([&](packed_imsi) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        handled.fetch_add(1);
+    });
+
+    auto imsi = packed_imsi::from_string("001010123456789").value();
+    for (int i = 0; i < 3; ++i) {
+        bus->publish<events::reject_session_event>(imsi);
+    }
+    bus->publish<events::create_session_event>(imsi);
+
+    bus->unsubscribe<events::reject_session_event>(batch);
+    bus->unsubscribe<events::create_session_event>(handler);
+    EXPECT_EQ(batched.load(), 3u);
+    EXPECT_EQ(handled.load(), 1);
+
+    bus->publish<events::reject_session_event>(imsi);
+    bus->publish<events::create_session_event>(imsi);
+    bus->flush();
+    EXPECT_EQ(batched.load(), 3u);
+    EXPECT_EQ(handled.load(), 1);
+    EXPECT_TRUE(bus->stats().empty());
+}
+
+TEST_F(EventBusTest, PublisherThreadDeliveryRunsInsidePublish) {
+    std::thread::id handled_on;
+
+    bus->subscribe<events::graceful_shutdown_event>([&]() { handled_on = std::this_thread::get_id(); },
+                                                   {.delivery = delivery_policy::publisher_thread, .name = "inline"});
+    bus->publish<events::graceful_shutdown_event>();
+
+    EXPECT_EQ(handled_on, std::this_thread::get_id());
+
+    auto stats = bus->stats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].name, "inline");
+    EXPECT_EQ(stats[0].event, "graceful_shutdown_event");
+    EXPECT_EQ(stats[0].delivered, 1u);
+    EXPECT_EQ(stats[0].queue_depth, 0u);
+}
+
+TEST_F(EventBusTest, DedicatedThreadKeepsPublishOrderAndCountsDeliveries) {
+    constexpr uint64_t events_num = 2000;
+
+    std::mutex mutex;
+    std::vector<uint64_t> seen;
+    std::thread::id handled_on;
+
+    bus->subscribe<events::create_session_event>(
+            [&](packed_imsi imsi) {
+                std::lock_guard<std::mutex> lock(mutex);
+                handled_on = std::this_thread::get_id();
+                seen.push_back(imsi.packed());
+            },
+            {.delivery = delivery_policy::dedicated_thread, .name = "ordered", .queue_capacity = 16});
+
+    std::vector<uint64_t> published;
+    for (uint64_t i = 0; i < events_num; ++i) {
+        auto imsi = packed_imsi::from_string("00101" + std::to_string(i)).value();
+        published.push_back(imsi.packed());
+        bus->publish<events::create_session_event>(imsi);
+    }
+
+    EXPECT_TRUE(eventually([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.size() == events_num;
+    }));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(seen, published);
+        EXPECT_NE(handled_on, std::this_thread::get_id());
+    }
+
+    auto stats = bus->stats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].delivery, delivery_policy::dedicated_thread);
+    EXPECT_EQ(stats[0].delivered, events_num);
+    EXPECT_EQ(stats[0].queue_depth, 0u);
+    EXPECT_GE(stats[0].max_queue_depth, 1u);
+    EXPECT_GE(stats[0].total_handler_ns, stats[0].max_handler_ns);
+    EXPECT_GT(stats[0].max_handler_ns, 0u);
+}
+
+TEST_F(EventBusTest, StatsCoverBatchSubscribersAndCountFailures) {
+    bus->subscribe<events::reject_session_event>([](packed_imsi) { throw std::runtime_error("handler failed"); },
+                                                {.name = "throws"});
+    bus->subscribe_batch<events::reject_session_event>([](std::span<const packed_imsi>) {},
+                                                      {.max_events = 1}, {.name = "batched"});
+
+    bus->publish<events::reject_session_event>(packed_imsi::from_string("001010123456789").value());
+
+    EXPECT_TRUE(eventually([&] {
+        auto stats = bus->stats();
+        return stats.size() == 2 && stats[0].delivered == 1 && stats[1].delivered == 1;
+    }));
+
+    auto stats = bus->stats();
+    EXPECT_EQ(stats[0].name, "throws");
+    EXPECT_EQ(stats[0].failed, 1u);
+    EXPECT_EQ(stats[1].name, "batched");
+    EXPECT_EQ(stats[1].failed, 0u);
+}
+
+// Meant for a -DMINI_PGW_SANITIZER=thread build, where any unsynchronized access to the subscriber lists is reported;
+// without it it still checks that late subscribers see every publish after subscribe() returns.
+TEST_F(EventBusTest, SubscribesWhilePublishersRun) {
+    constexpr int publishers_num = 4;
+    constexpr int subscribers_num = 24;
+    constexpr uint64_t after_subscribe = 100;
+
+    auto imsi = packed_imsi::from_string("001010123456789").value();
+    std::vector<std::unique_ptr<std::atomic<uint64_t>>> counts;
+    for (int i = 0; i < subscribers_num + 1; ++i) {
+        counts.push_back(std::make_unique<std::atomic<uint64_t>>(0));
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::jthread> publishers;
+    for (int p = 0; p < publishers_num; ++p) {
+        publishers.emplace_back([&]() {
+            while (not stop.load()) {
+                bus->publish<events::create_session_event>(imsi);
+                bus->publish<events::reject_session_event>(imsi);
+            }
+        });
+    }
+
+    constexpr delivery_policy policies[] = {delivery_policy::publisher_thread, delivery_policy::pool,
+                                            delivery_policy::dedicated_thread};
+    for (int i = 0; i < subscribers_num; ++i) {
+        auto &count = *counts[i];
+        bus->subscribe<events::create_session_event>([&count](packed_imsi) { count.fetch_add(1); },
+                                                    {.delivery = policies[i % 3], .name = std::to_string(i)});
+        // Reading the lists as they change is part of the test.
+        EXPECT_EQ(bus->stats().size(), static_cast<size_t>(i + 1));
+    }
+    auto &batched = *counts[subscribers_num];
+    bus->subscribe_batch<events::reject_session_event>(
+            [&batched](std::span<const packed_imsi> imsis) { batched.fetch_add(imsis.size()); },
+            {.max_events = 8, .max_delay = std::chrono::milliseconds(1)}, {.name = "batched"});
+
+    stop.store(true);
+    publishers.clear();
+
+    for (uint64_t i = 0; i < after_subscribe; ++i) {
+        bus->publish<events::create_session_event>(imsi);
+        bus->publish<events::reject_session_event>(imsi);
+    }
+    bus->flush();
+
+    EXPECT_TRUE(eventually([&] {
+        auto stats = bus->stats();
+        for (size_t i = 0; i < stats.size(); ++i) {
+            if (stats[i].queue_depth != 0 || (i < subscribers_num && stats[i].delivered != counts[i]->load())) {
+                return false;
+            }
+        }
+        return true;
+    }));
+    for (const auto &count: counts) {
+        EXPECT_GE(count->load(), after_subscribe);
+    }
+}
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mpsc_ring.hpp>
+
+TEST(MpscRingTest, RoundsUpAndRefusesWhenFull) {
+    mpsc_ring<int> ring(3);
+    ASSERT_EQ(ring.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        int value = i;
+        EXPECT_TRUE(ring.try_push(value));
+    }
+    int extra = 42;
+    EXPECT_FALSE(ring.try_push(extra));
+    EXPECT_EQ(extra, 42);
+    EXPECT_EQ(ring.size(), 4u);
+
+    int out = -1;
+    ASSERT_TRUE(ring.try_pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(ring.try_push(extra));
+
+    for (int expected: {1, 2, 3, 42}) {
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, expected);
+    }
+    EXPECT_FALSE(ring.try_pop(out));
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(MpscRingTest, KeepsEachProducersOrderAndLosesNothing) {
+    constexpr uint64_t producers_num = 4;
+    constexpr uint64_t per_producer = 50'000;
+
+    // Small enough that producers keep running into a full ring.
+    mpsc_ring<uint64_t> ring(64);
+
+    std::vector<std::jthread> producers;
+    for (uint64_t p = 0; p < producers_num; ++p) {
+        producers.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                uint64_t value = p * per_producer + i;
+                while (not ring.try_push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(producers_num, 0);
+    uint64_t received = 0;
+    while (received < producers_num * per_producer) {
+        uint64_t value = 0;
+        if (not ring.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint64_t producer = value / per_producer;
+        ASSERT_EQ(value % per_producer, next[producer]);
+        ++next[producer];
+        ++received;
+    }
+
+    for (auto count: next) {
+        EXPECT_EQ(count, per_producer);
+    }
+}
@@ -0,0 +1,50 @@
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include <packed_imsi.hpp>
+#include <utility.hpp>
+
+class PackedImsiTest : public ::testing::Test {};
+
+TEST_F(PackedImsiTest, RoundTripsThroughString) {
+    auto imsi = packed_imsi::from_string("001010123456789");
+
+    ASSERT_TRUE(imsi.has_value());
+    EXPECT_EQ(imsi->packed(), 0xF001010123456789ull);
+    EXPECT_EQ(imsi->size(), 15u);
+    EXPECT_EQ(imsi->to_string(), "001010123456789");
+}
+
+TEST_F(PackedImsiTest, KeepsLeadingZerosDistinct) {
+    auto short_imsi = packed_imsi::from_string("123456").value();
+    auto padded_imsi = packed_imsi::from_string("0123456").value();
+
+    EXPECT_NE(short_imsi, padded_imsi);
+    EXPECT_EQ(padded_imsi.to_string(), "0123456");
+}
+
+TEST_F(PackedImsiTest, RejectsInvalidStrings) {
+    EXPECT_FALSE(packed_imsi::from_string("").has_value());
+    EXPECT_FALSE(packed_imsi::from_string("1234567890123456").has_value());
+    EXPECT_FALSE(packed_imsi::from_string("12345a").has_value());
+}
+
+TEST_F(PackedImsiTest, DecoderMatchesStringForm) {
+    auto packet = utility::encode_imsi_to_bcd("001010000000001").value();
+    auto decoded = utility::decode_imsi_from_bcd(packet);
+
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded.value(), packed_imsi::from_string("001010000000001").value());
+}
+
+TEST_F(PackedImsiTest, HashesAsContainerKey) {
+    std::unordered_set<packed_imsi> imsis;
+    for (int i = 0; i < 1000; ++i) {
+        imsis.insert(packed_imsi::from_string("00101" + std::to_string(1000000000 + i)).value());
+    }
+
+    EXPECT_EQ(imsis.size(), 1000u);
+    EXPECT_TRUE(imsis.contains(packed_imsi::from_string("001011000000500").value()));
+    EXPECT_FALSE(imsis.contains(packed_imsi::from_string("001011000001000").value()));
+}
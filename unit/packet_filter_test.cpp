@@ -0,0 +1,153 @@
+#include <arpa/inet.h>
+#include <array>
+#include <map>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packet_filter.hpp>
+#include <utility.hpp>
+
+class PacketFilterTest : public ::testing::Test {
+protected:
+    static constexpr uint32_t GROUPS = 4;
+
+    void TearDown() override {
+        for (int fd: _sockets) {
+            close(fd);
+        }
+    }
+
+    int make_socket(uint16_t port, bool reuse_port) {
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        EXPECT_GE(fd, 0);
+        _sockets.push_back(fd);
+
+        if (reuse_port) {
+            int enable = 1;
+            EXPECT_EQ(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)), 0);
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+
+        return fd;
+    }
+
+    static uint16_t bound_port(int fd) {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+        return ntohs(addr.sin_port);
+    }
+
+    static void attach(int fd, int option, std::vector<sock_filter> code) {
+        sock_fprog program{static_cast<unsigned short>(code.size()), code.data()};
+        ASSERT_EQ(setsockopt(fd, SOL_SOCKET, option, &program, sizeof(program)), 0);
+    }
+
+    static void send_to(int fd, uint16_t port, std::span<const uint8_t> packet) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(sendto(fd, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)),
+                  static_cast<ssize_t>(packet.size()));
+    }
+
+    static std::vector<std::vector<uint8_t>> drain(int fd) {
+        std::vector<std::vector<uint8_t>> packets;
+        std::array<uint8_t, 128> buffer;
+
+        pollfd pfd{fd, POLLIN, 0};
+        while (poll(&pfd, 1, 50) > 0) {
+            ssize_t received = recv(fd, buffer.data(), buffer.size(), 0);
+            if (received < 0) {
+                break;
+            }
+            packets.emplace_back(buffer.begin(), buffer.begin() + received);
+        }
+
+        return packets;
+    }
+
+    std::vector<int> _sockets;
+};
+
+TEST_F(PacketFilterTest, SteeringIndexIsStablePerImsi) {
+    auto packet = utility::encode_imsi_to_bcd("001010123456789").value();
+
+    EXPECT_EQ(packet_filter::steering_index(packet, GROUPS), packet_filter::steering_index(packet, GROUPS));
+    EXPECT_LT(packet_filter::steering_index(packet, GROUPS), GROUPS);
+}
+
+TEST_F(PacketFilterTest, MalformedProgramDropsJunk) {
+    int server = make_socket(0, false);
+    attach(server, SO_ATTACH_FILTER, packet_filter::malformed_program());
+    uint16_t port = bound_port(server);
+    int client = make_socket(0, false);
+
+    auto valid = utility::encode_imsi_to_bcd("001010123456789").value();
+    std::vector<uint8_t> too_short{1, 0, 1};
+    std::vector<uint8_t> wrong_type = valid;
+    wrong_type[0] = 2;
+    std::vector<uint8_t> too_long(utility::MAX_IMSI_PACKET_SIZE + 1, 0x11);
+    too_long[0] = utility::IMSI_TYPE;
+
+    send_to(client, port, too_short);
+    send_to(client, port, wrong_type);
+    send_to(client, port, too_long);
+    send_to(client, port, valid);
+
+    auto received = drain(server);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received.front(), valid);
+}
+
+TEST_F(PacketFilterTest, SteeringProgramKeepsImsiOnOneSocket) {
+    std::vector<int> group;
+    group.push_back(make_socket(0, true));
+    uint16_t port = bound_port(group.front());
+    for (uint32_t i = 1; i < GROUPS; ++i) {
+        group.push_back(make_socket(port, true));
+    }
+    attach(group.front(), SO_ATTACH_REUSEPORT_CBPF, packet_filter::steering_program(GROUPS));
+
+    std::vector<int> clients;
+    for (int i = 0; i < 4; ++i) {
+        clients.push_back(make_socket(0, false));
+    }
+
+    std::map<std::vector<uint8_t>, uint32_t> expected;
+    for (int i = 0; i < 32; ++i) {
+        auto packet = utility::encode_imsi_to_bcd("0010100" + std::to_string(10000000 + i * 7919)).value();
+        expected[packet] = packet_filter::steering_index(packet, GROUPS);
+
+        // Different source ports must not change the destination reactor.
+        for (int client: clients) {
+            send_to(client, port, packet);
+        }
+    }
+
+    std::map<uint32_t, size_t> per_socket;
+    size_t total = 0;
+    for (uint32_t index = 0; index < GROUPS; ++index) {
+        for (const auto &packet: drain(group[index])) {
+            ASSERT_TRUE(expected.contains(packet));
+            EXPECT_EQ(expected[packet], index);
+            per_socket[index]++;
+            total++;
+        }
+    }
+
+    EXPECT_EQ(total, expected.size() * clients.size());
+    EXPECT_GT(per_socket.size(), 1u);
+}
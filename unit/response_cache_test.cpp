@@ -0,0 +1,82 @@
+#include <arpa/inet.h>
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <response_cache.hpp>
+#include <utility.hpp>
+
+class ResponseCacheTest : public ::testing::Test {
+protected:
+    static sockaddr_in client(uint16_t port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return addr;
+    }
+
+    response_cache::clock::time_point _now = response_cache::clock::now();
+};
+
+TEST_F(ResponseCacheTest, ReplaysWithinTtl) {
+    response_cache cache(64, std::chrono::milliseconds(100));
+    auto request = utility::encode_imsi_to_bcd("001010123456789").value();
+
+    EXPECT_FALSE(cache.find(client(5000), request, _now).has_value());
+
+    cache.insert(client(5000), request, packet_result::created, _now);
+
+    auto replayed = cache.find(client(5000), request, _now + std::chrono::milliseconds(50));
+    ASSERT_TRUE(replayed.has_value());
+    EXPECT_EQ(replayed.value(), packet_result::created);
+
+    EXPECT_FALSE(cache.find(client(5000), request, _now + std::chrono::milliseconds(100)).has_value());
+}
+
+TEST_F(ResponseCacheTest, KeyedByClientAndRequestBytes) {
+    response_cache cache(64, std::chrono::milliseconds(100));
+    auto request = utility::encode_imsi_to_bcd("001010123456789").value();
+    auto other_request = utility::encode_imsi_to_bcd("001010123456788").value();
+
+    cache.insert(client(5000), request, packet_result::created, _now);
+
+    EXPECT_FALSE(cache.find(client(5001), request, _now).has_value());
+    EXPECT_FALSE(cache.find(client(5000), other_request, _now).has_value());
+}
+
+TEST_F(ResponseCacheTest, RefreshKeepsLatestResult) {
+    response_cache cache(64, std::chrono::milliseconds(100));
+    auto request = utility::encode_imsi_to_bcd("001010123456789").value();
+
+    cache.insert(client(5000), request, packet_result::created, _now);
+    cache.insert(client(5000), request, packet_result::rejected, _now + std::chrono::milliseconds(80));
+
+    auto replayed = cache.find(client(5000), request, _now + std::chrono::milliseconds(150));
+    ASSERT_TRUE(replayed.has_value());
+    EXPECT_EQ(replayed.value(), packet_result::rejected);
+}
+
+TEST_F(ResponseCacheTest, OversizedRequestsAreNotCached) {
+    response_cache cache(64, std::chrono::milliseconds(100));
+    std::vector<uint8_t> request(response_cache::MAX_REQUEST_SIZE + 1, 0x11);
+
+    cache.insert(client(5000), request, packet_result::created, _now);
+
+    EXPECT_FALSE(cache.find(client(5000), request, _now).has_value());
+}
+
+TEST_F(ResponseCacheTest, StaysBoundedUnderChurn) {
+    response_cache cache(16, std::chrono::milliseconds(100));
+
+    for (int i = 0; i < 1000; ++i) {
+        auto request = utility::encode_imsi_to_bcd("00101" + std::to_string(1000000000 + i)).value();
+        cache.insert(client(5000), request, packet_result::created, _now);
+    }
+
+    EXPECT_EQ(cache.capacity(), 16u);
+
+    auto newest = utility::encode_imsi_to_bcd("00101" + std::to_string(1000000000 + 999)).value();
+    EXPECT_TRUE(cache.find(client(5000), newest, _now).has_value());
+}
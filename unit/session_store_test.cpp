@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <session_store.hpp>
+
+class SessionStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() / "test_session_state.bin";
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    static std::vector<session_record> restore_all(session_store &store) {
+        std::vector<session_record> restored;
+        store.restore([&](const session_record &record) { restored.push_back(record); });
+        return restored;
+    }
+
+    static session_record record(uint64_t imsi) {
+        return {.imsi = imsi, .created_at_ms = static_cast<int64_t>(imsi) * 10, .expires_at_ms = 1000};
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(SessionStoreTest, NewFileRestoresNothing) {
+    session_store store(path);
+
+    EXPECT_TRUE(restore_all(store).empty());
+    EXPECT_EQ(store.extents(), 0u);
+}
+
+TEST_F(SessionStoreTest, LiveRecordsSurviveReopen) {
+    {
+        session_store store(path);
+        session_store::region first;
+        session_store::region second;
+        first.attach(store);
+        second.attach(store);
+
+        first.write(0, record(1));
+        first.write(1, record(2));
+        second.write(0, record(3));
+        // Beyond the first extent, so the region takes a second one.
+        second.write(session_store::EXTENT_RECORDS, record(4));
+        first.clear(1);
+
+        EXPECT_EQ(store.extents(), 3u);
+    }
+
+    session_store store(path);
+    auto restored = restore_all(store);
+    std::sort(restored.begin(), restored.end(),
+              [](const session_record &a, const session_record &b) { return a.imsi < b.imsi; });
+
+    ASSERT_EQ(restored.size(), 3u);
+    EXPECT_EQ(restored[0].imsi, 1u);
+    EXPECT_EQ(restored[1].imsi, 3u);
+    EXPECT_EQ(restored[2].imsi, 4u);
+    EXPECT_EQ(restored[2].created_at_ms, 40);
+    EXPECT_EQ(restored[2].expires_at_ms, 1000);
+
+    // Opening hands the records over and starts the store empty, reusing the file's extents.
+    EXPECT_TRUE(restore_all(store).empty());
+    session_store::region region;
+    region.attach(store);
+    region.write(0, record(5));
+    EXPECT_EQ(store.extents(), 3u);
+}
+
+TEST_F(SessionStoreTest, ReusedExtentsDropUnwrittenRecords) {
+    {
+        session_store store(path);
+        session_store::region region;
+        region.attach(store);
+        region.write(0, record(1));
+        region.write(1, record(2));
+    }
+    {
+        session_store store(path);
+        ASSERT_EQ(restore_all(store).size(), 2u);
+
+        session_store::region region;
+        region.attach(store);
+        region.write(0, record(2));
+    }
+
+    session_store store(path);
+    auto restored = restore_all(store);
+    ASSERT_EQ(restored.size(), 1u);
+    EXPECT_EQ(restored[0].imsi, 2u);
+}
+
+TEST_F(SessionStoreTest, DetachedRegionIgnoresWrites) {
+    session_store::region region;
+    region.write(0, record(1));
+    region.clear(0);
+}
+
+TEST_F(SessionStoreTest, RejectsForeignFile) {
+    std::ofstream(path) << "not a session state file";
+
+    EXPECT_THROW(session_store store(path), session_store_exception);
+}
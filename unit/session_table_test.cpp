@@ -0,0 +1,144 @@
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <session_table.hpp>
+
+class SessionTableTest : public ::testing::Test {
+protected:
+    static packed_imsi imsi(uint64_t n) {
+        return packed_imsi::from_string("00101" + std::to_string(1000000000 + n)).value();
+    }
+};
+
+TEST_F(SessionTableTest, InsertFindErase) {
+    session_table table;
+
+    auto handle = table.insert(imsi(1));
+    ASSERT_TRUE(handle.valid());
+    EXPECT_FALSE(table.insert(imsi(1)).valid());
+
+    EXPECT_EQ(table.find(imsi(1)), handle);
+    EXPECT_TRUE(table.contains(imsi(1)));
+    EXPECT_EQ(table.get(handle)->get_imsi(), imsi(1));
+
+    EXPECT_TRUE(table.erase(imsi(1)));
+    EXPECT_FALSE(table.erase(imsi(1)));
+    EXPECT_FALSE(table.contains(imsi(1)));
+    EXPECT_TRUE(table.empty());
+}
+
+TEST_F(SessionTableTest, HandlesStayStableWhileOthersAreErased) {
+    session_table table;
+
+    std::vector<session_handle> handles;
+    for (uint64_t i = 0; i < 100; ++i) {
+        handles.push_back(table.insert(imsi(i)));
+    }
+    for (uint64_t i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(table.erase(handles[i]));
+    }
+
+    for (uint64_t i = 1; i < 100; i += 2) {
+        ASSERT_NE(table.get(handles[i]), nullptr);
+        EXPECT_EQ(table.get(handles[i])->get_imsi(), imsi(i));
+    }
+    EXPECT_EQ(table.size(), 50u);
+}
+
+TEST_F(SessionTableTest, StaleHandleDoesNotResolveAfterSlotReuse) {
+    session_table table;
+
+    auto old_handle = table.insert(imsi(1));
+    EXPECT_TRUE(table.erase(old_handle));
+
+    auto new_handle = table.insert(imsi(2));
+    EXPECT_EQ(new_handle.slot, old_handle.slot);
+    EXPECT_EQ(table.get(old_handle), nullptr);
+    EXPECT_FALSE(table.erase(old_handle));
+    EXPECT_TRUE(table.contains(imsi(2)));
+}
+
+TEST_F(SessionTableTest, PreallocateKeepsSessionsAndHandles) {
+    session_table table;
+
+    std::vector<session_handle> handles;
+    for (uint64_t i = 0; i < 100; ++i) {
+        handles.push_back(table.insert(imsi(i)));
+    }
+
+    table.preallocate(10000, {.mapped = true, .prefault = true});
+    size_t reserved = table.memory_usage();
+
+    for (uint64_t i = 0; i < 100; ++i) {
+        ASSERT_NE(table.get(handles[i]), nullptr);
+        EXPECT_EQ(table.get(handles[i])->get_imsi(), imsi(i));
+        EXPECT_TRUE(table.concurrent_contains(imsi(i)));
+    }
+
+    // Filling up to the preallocated size takes no more memory.
+    for (uint64_t i = 100; i < 10000; ++i) {
+        ASSERT_TRUE(table.insert(imsi(i)).valid());
+    }
+    EXPECT_EQ(table.memory_usage(), reserved);
+    EXPECT_EQ(table.size(), 10000u);
+}
+
+TEST_F(SessionTableTest, MatchesReferenceUnderRandomChurn) {
+    session_table table;
+    std::unordered_set<uint64_t> reference;
+    std::mt19937_64 rng(42);
+
+    for (int i = 0; i < 200000; ++i) {
+        uint64_t n = rng() % 5000;
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(table.erase(imsi(n)), reference.erase(n) == 1);
+        } else {
+            EXPECT_EQ(table.insert(imsi(n)).valid(), reference.insert(n).second);
+        }
+    }
+
+    ASSERT_EQ(table.size(), reference.size());
+    for (uint64_t n = 0; n < 5000; ++n) {
+        EXPECT_EQ(table.contains(imsi(n)), reference.contains(n));
+    }
+    for (const auto &stored: table.sessions()) {
+        EXPECT_TRUE(table.find(stored.get_imsi()).valid());
+    }
+}
+
+TEST_F(SessionTableTest, ConcurrentLookupsSeeStableKeysThroughChurn) {
+    session_table table;
+    (void) table.insert(imsi(0));
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> wrong{0};
+
+    std::jthread reader([&]() {
+        while (not done.load(std::memory_order_relaxed)) {
+            if (not table.concurrent_contains(imsi(0)) || table.concurrent_contains(imsi(999999))) {
+                wrong.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Growth, swap-removal and backward shifts all happen while the reader probes.
+    for (int round = 0; round < 20; ++round) {
+        for (uint64_t n = 1; n < 20000; ++n) {
+            (void) table.insert(imsi(n));
+        }
+        for (uint64_t n = 1; n < 20000; ++n) {
+            EXPECT_TRUE(table.erase(imsi(n)));
+        }
+    }
+
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(wrong.load(), 0u);
+    EXPECT_TRUE(table.concurrent_contains(imsi(0)));
+}
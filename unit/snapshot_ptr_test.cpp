@@ -0,0 +1,79 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <snapshot_ptr.hpp>
+
+namespace {
+    // Both halves always match in a live value; destruction breaks that, so a reader of a freed snapshot notices.
+    struct pair_value {
+        explicit pair_value(uint64_t value) : first(value), second(value) {}
+        ~pair_value() { second = ~first; }
+
+        uint64_t first;
+        uint64_t second;
+    };
+} // namespace
+
+TEST(SnapshotPtrTest, ReadsLatestPublished) {
+    snapshot_ptr<int> value(std::make_unique<const int>(1));
+    EXPECT_EQ(*value.read(), 1);
+
+    value.publish(std::make_unique<const int>(2));
+    EXPECT_EQ(*value.read(), 2);
+}
+
+TEST(SnapshotPtrTest, ReaderKeepsOldSnapshotUntilReleased) {
+    snapshot_ptr<pair_value> value(std::make_unique<const pair_value>(1));
+
+    std::atomic<bool> published{false};
+    std::jthread writer;
+    {
+        auto pinned = value.read();
+
+        writer = std::jthread([&]() {
+            value.publish(std::make_unique<const pair_value>(2));
+            published.store(true);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(published.load());
+        EXPECT_EQ(pinned->first, 1u);
+        EXPECT_EQ(pinned->second, 1u);
+    }
+    writer.join();
+
+    EXPECT_TRUE(published.load());
+    EXPECT_EQ(value.read()->first, 2u);
+}
+
+TEST(SnapshotPtrTest, ConcurrentReadersNeverSeeFreedSnapshot) {
+    snapshot_ptr<pair_value> value(std::make_unique<const pair_value>(0));
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::vector<std::jthread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            while (not stop.load(std::memory_order_relaxed)) {
+                auto snapshot = value.read();
+                if (snapshot->first != snapshot->second) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= 2000; ++i) {
+        value.publish(std::make_unique<const pair_value>(i));
+    }
+    stop.store(true);
+    readers.clear();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(value.read()->first, 2000u);
+}
@@ -0,0 +1,97 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <timer_wheel.hpp>
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    using wheel = timer_wheel<std::string>;
+
+    static std::vector<std::pair<uint64_t, std::string>> advance(wheel &timers, uint64_t ticks) {
+        std::vector<std::pair<uint64_t, std::string>> expired;
+        for (uint64_t i = 0; i < ticks; ++i) {
+            timers.advance(1, [&](wheel::timer_id, std::string payload) {
+                expired.emplace_back(timers.now(), std::move(payload));
+            });
+        }
+        return expired;
+    }
+};
+
+TEST_F(TimerWheelTest, FiresOnDueTick) {
+    wheel timers;
+    (void) timers.schedule(3, "a");
+    (void) timers.schedule(1, "b");
+    (void) timers.schedule(0, "c");
+
+    auto expired = advance(timers, 5);
+
+    ASSERT_EQ(expired.size(), 3u);
+    EXPECT_EQ(expired[0], std::make_pair(uint64_t{1}, std::string("b")));
+    EXPECT_EQ(expired[1], std::make_pair(uint64_t{1}, std::string("c")));
+    EXPECT_EQ(expired[2], std::make_pair(uint64_t{3}, std::string("a")));
+    EXPECT_TRUE(timers.empty());
+}
+
+TEST_F(TimerWheelTest, CancelRemovesTimer) {
+    wheel timers;
+    auto id = timers.schedule(2, "a");
+    (void) timers.schedule(2, "b");
+
+    EXPECT_TRUE(timers.cancel(id));
+    EXPECT_FALSE(timers.cancel(id));
+    EXPECT_EQ(timers.size(), 1u);
+
+    auto expired = advance(timers, 2);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0].second, "b");
+}
+
+TEST_F(TimerWheelTest, StaleIdDoesNotCancelReusedSlot) {
+    wheel timers;
+    auto old_id = timers.schedule(1, "a");
+    (void) advance(timers, 1);
+
+    (void) timers.schedule(5, "b");
+    EXPECT_FALSE(timers.cancel(old_id));
+    EXPECT_EQ(timers.size(), 1u);
+}
+
+TEST_F(TimerWheelTest, CascadesLongDelaysExactly) {
+    wheel timers;
+    std::vector<uint64_t> delays{255, 256, 257, 65535, 65536, 65537, 70000, 16777216 + 3};
+    for (auto delay: delays) {
+        (void) timers.schedule(delay, std::to_string(delay));
+    }
+
+    std::vector<uint64_t> fired;
+    timers.advance(delays.back(), [&](wheel::timer_id, std::string payload) {
+        EXPECT_EQ(std::to_string(timers.now()), payload);
+        fired.push_back(timers.now());
+    });
+
+    EXPECT_EQ(fired, delays);
+    EXPECT_TRUE(timers.empty());
+}
+
+TEST_F(TimerWheelTest, HandlesManyPendingTimers) {
+    constexpr uint64_t count = 1'000'000;
+    wheel timers(count);
+
+    std::vector<wheel::timer_id> ids;
+    ids.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        ids.push_back(timers.schedule(1 + i % 3000, {}));
+    }
+    for (uint64_t i = 0; i < count; i += 2) {
+        EXPECT_TRUE(timers.cancel(ids[i]));
+    }
+
+    uint64_t fired = 0;
+    timers.advance(3000, [&](wheel::timer_id, std::string) { fired++; });
+
+    EXPECT_EQ(fired, count / 2);
+    EXPECT_TRUE(timers.empty());
+}
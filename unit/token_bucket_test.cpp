@@ -0,0 +1,46 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include <token_bucket.hpp>
+
+using namespace std::chrono_literals;
+
+TEST(TokenBucketTest, StartsEmptyAndAccruesWithTime) {
+    auto start = token_bucket::clock::time_point{};
+    token_bucket bucket(1000, 100, start);
+
+    EXPECT_EQ(bucket.take(start), 0u);
+    EXPECT_EQ(bucket.take(start + 10ms), 10u);
+    EXPECT_EQ(bucket.take(start + 10ms), 0u);
+    EXPECT_EQ(bucket.take(start + 35ms), 25u);
+}
+
+TEST(TokenBucketTest, CarriesFractionsBelowOnePerPoll) {
+    auto now = token_bucket::clock::time_point{};
+    token_bucket bucket(30, 10, now);
+
+    // 30 per second polled every 10 ms earns 0.3 a poll; a second's worth of polls still hands out exactly 30.
+    size_t total = 0;
+    for (int i = 0; i < 100; ++i) {
+        now += 10ms;
+        total += bucket.take(now);
+    }
+    EXPECT_EQ(total, 30u);
+}
+
+TEST(TokenBucketTest, IdleTimeIsCappedByBurst) {
+    auto start = token_bucket::clock::time_point{};
+    token_bucket bucket(1000, 50, start);
+
+    EXPECT_EQ(bucket.take(start + 10s), 50u);
+    EXPECT_EQ(bucket.take(start + 10s + 5ms), 5u);
+}
+
+TEST(TokenBucketTest, ClockGoingBackwardsEarnsNothing) {
+    auto start = token_bucket::clock::time_point{} + 1s;
+    token_bucket bucket(1000, 100, start);
+
+    EXPECT_EQ(bucket.take(start - 500ms), 0u);
+    EXPECT_EQ(bucket.take(start + 20ms), 20u);
+}
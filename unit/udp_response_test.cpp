@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>
+
+#include <udp_response.hpp>
+
+class UdpResponseTest : public ::testing::Test {};
+
+TEST_F(UdpResponseTest, EncodeResults) {
+    EXPECT_EQ(udp_response::encode(packet_result::created), "created");
+    EXPECT_EQ(udp_response::encode(packet_result::rejected), "rejected");
+    EXPECT_EQ(udp_response::encode(std::unexpected(packet_manager_error::packet_parsing_failed)),
+              "Error: packet_parsing_failed");
+    EXPECT_EQ(udp_response::encode(std::unexpected(packet_manager_error::capacity_exceeded)),
+              "Error: capacity_exceeded");
+}
+
+TEST_F(UdpResponseTest, EncodeReturnsStableStorage) {
+    auto first = udp_response::encode(std::unexpected(packet_manager_error::packet_parsing_failed));
+    auto second = udp_response::encode(std::unexpected(packet_manager_error::packet_parsing_failed));
+
+    EXPECT_EQ(first.data(), second.data());
+}
@@ -26,7 +26,7 @@ TEST_F(UtilityTest, DecodeValidBcd) {
     auto result = utility::decode_imsi_from_bcd(packet);
 
     ASSERT_TRUE(result.has_value());
-    EXPECT_EQ(result.value(), "12345678");
+    EXPECT_EQ(result.value().to_string(), "12345678");
 }
 
 TEST_F(UtilityTest, DecodeWithPadding) {
@@ -34,7 +34,7 @@ TEST_F(UtilityTest, DecodeWithPadding) {
     auto result = utility::decode_imsi_from_bcd(packet);
 
     ASSERT_TRUE(result.has_value());
-    EXPECT_EQ(result.value(), "1234567");
+    EXPECT_EQ(result.value().to_string(), "1234567");
 }
 
 TEST_F(UtilityTest, DecodePacketTooShort) {
@@ -87,7 +87,7 @@ TEST_F(UtilityTest, EncodeInvalidImsi) {
 TEST_F(UtilityTest, TimestampFormat) {
     auto timestamp = utility::get_current_timestamp();
 
-    EXPECT_GT(timestamp.length(), 19);
+    EXPECT_GT(timestamp.length(), 19u);
     EXPECT_EQ(timestamp[4], '-');
     EXPECT_EQ(timestamp[7], '-');
     EXPECT_EQ(timestamp[10], ' ');
@@ -95,3 +95,11 @@ TEST_F(UtilityTest, TimestampFormat) {
     EXPECT_EQ(timestamp[16], ':');
     EXPECT_EQ(timestamp[19], '.');
 }
+
+TEST_F(UtilityTest, DecodeTooManyDigits) {
+    std::vector<uint8_t> packet = {0x01, 0x00, 0x09, 0x00, 0x21, 0x43, 0x65, 0x87, 0x09, 0x21, 0x43, 0x65};
+    auto result = utility::decode_imsi_from_bcd(packet);
+
+    EXPECT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), utility::decode_error::invalid_imsi_length);
+}